@@ -9,34 +9,147 @@
  * Date: November 2025
  */
 
-#include "ChronoSenseArduino.h"
+#include "chronoSenseArduino.h"
 
 // Static instance for WebSocket callbacks
 ChronoSense* ChronoSense::instance = nullptr;
 
+#ifdef ESP32
+// Last good WiFi/server parameters. RTC memory survives deep sleep;
+// NVS survives power loss.
+#define CS_NETWORK_CACHE_MAGIC 0x43534E31  // "CSN1"
+
+struct ChronoSenseNetworkCache {
+    uint32_t magic;
+    uint32_t ssidHash;
+    uint8_t bssid[6];
+    int32_t channel;
+    uint32_t localIP;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+    uint32_t serverHash;
+    uint32_t serverIP;
+};
+
+RTC_DATA_ATTR static ChronoSenseNetworkCache networkCache;
+
+static uint32_t hashString(const char* text, uint32_t seed = 2166136261UL) {
+    // FNV-1a
+    uint32_t hash = seed;
+    while (*text != '\0') {
+        hash = (hash ^ (uint8_t)*text++) * 16777619UL;
+    }
+    return hash;
+}
+
+static bool loadNetworkCache(uint32_t ssidHash) {
+    if (networkCache.magic != CS_NETWORK_CACHE_MAGIC) {
+        Preferences prefs;
+        prefs.begin("chronosense", true);
+        size_t length = prefs.getBytes("net", &networkCache, sizeof(networkCache));
+        prefs.end();
+        if (length != sizeof(networkCache)) {
+            networkCache.magic = 0;
+        }
+    }
+    return networkCache.magic == CS_NETWORK_CACHE_MAGIC && networkCache.ssidHash == ssidHash;
+}
+
+static void saveNetworkCache() {
+    // Only write flash when something changed
+    ChronoSenseNetworkCache stored;
+    Preferences prefs;
+    prefs.begin("chronosense", false);
+    if (prefs.getBytes("net", &stored, sizeof(stored)) != sizeof(stored) ||
+        memcmp(&stored, &networkCache, sizeof(stored)) != 0) {
+        prefs.putBytes("net", &networkCache, sizeof(networkCache));
+    }
+    prefs.end();
+}
+
+static void eraseNetworkCache() {
+    // Drop the record from RTC memory and flash
+    networkCache.magic = 0;
+    Preferences prefs;
+    prefs.begin("chronosense", false);
+    prefs.remove("net");
+    prefs.end();
+}
+
+static void forgetServerAddress() {
+    // The cached address survives reboots, so clear it in flash as well
+    if (networkCache.serverIP == 0) {
+        return;
+    }
+    networkCache.serverIP = 0;
+    networkCache.serverHash = 0;
+    if (networkCache.magic == CS_NETWORK_CACHE_MAGIC) {
+        saveNetworkCache();
+    }
+}
+#endif
+
 ChronoSense::ChronoSense(ChronoSenseMode mode) {
     this->mode = mode;
-    this->deviceName = "Arduino-Sensor";
+    ChronoSenseUtils::copyString(this->deviceName, sizeof(this->deviceName), "Arduino-Sensor");
+    #if defined(ESP32) || defined(ESP8266)
+    this->wifiSSID[0] = '\0';
+    this->wifiPassword[0] = '\0';
+    this->serverHost[0] = '\0';
+    this->serverPort = 8080;
+    this->commandLength = 0;
+    this->commandOverflow = false;
+    #endif
     this->radioChannel = 144;
     this->checksumEnabled = true;
     this->validation = VALIDATE_CHECKSUM;
-    this->transmissionInterval = 5000;
+    this->transmissionInterval = 0;     // 0 = send every reading
+    this->aggregationWindow = 1;
+    for (int i = 0; i < 10; i++) {
+        this->channelPrecision[i] = 1;
+    }
+    this->encoding = CS_ENCODING_JSON;
     this->connected = false;
     this->bufferEnabled = false;
     this->bufferIndex = 0;
+    this->bufferCount = 0;
+    this->aggregateValueCount = 0;
+    this->aggregateReadings = 0;
+    this->flowControlEnabled = false;
+    this->credits = 0;
+    this->radio = nullptr;
+    this->ownsRadio = false;
+    this->pendingLength = 0;
+    this->packetStarted = 0;
+    this->radioBatchTimeout = 1000;
+    this->connectState = CONNECT_IDLE;
+    this->fastConnectEnabled = true;
+    this->backgroundConnect = false;
+    this->fastConnectUsed = false;
+    this->connectStarted = 0;
+    this->connectDuration = 0;
+    this->firstReadingTime = 0;
     this->lastTransmission = 0;
+    this->lastReconnectAttempt = 0;
+    this->reconnectDelay = CS_RECONNECT_MIN_DELAY;
     this->connectionTimeout = 30000;
-    this->serverPort = 8080;
+    this->droppedCount = 0;
     
     // Initialize callback pointers
     this->onConnectCallback = nullptr;
     this->onDisconnectCallback = nullptr;
     this->onDataSentCallback = nullptr;
     this->onErrorCallback = nullptr;
+    this->onDataSentBytesCallback = nullptr;
+    this->onErrorBytesCallback = nullptr;
+    
+    resetHeapStats();
     
     #ifdef ESP32
     this->webSocket = nullptr;
     this->bluetooth = nullptr;
+    this->tcpClient = nullptr;
     #endif
     
     // Set static instance for callbacks
@@ -44,6 +157,10 @@ ChronoSense::ChronoSense(ChronoSenseMode mode) {
 }
 
 ChronoSense::~ChronoSense() {
+    if (ownsRadio && radio != nullptr) {
+        delete radio;
+    }
+    
     #ifdef ESP32
     if (webSocket != nullptr) {
         delete webSocket;
@@ -51,6 +168,9 @@ ChronoSense::~ChronoSense() {
     if (bluetooth != nullptr) {
         delete bluetooth;
     }
+    if (tcpClient != nullptr) {
+        delete tcpClient;
+    }
     #endif
 }
 
@@ -59,9 +179,14 @@ bool ChronoSense::begin() {
 }
 
 bool ChronoSense::begin(String deviceName) {
-    this->deviceName = deviceName;
+    return begin(deviceName.c_str());
+}
+
+bool ChronoSense::begin(const char* deviceName) {
+    setDeviceName(deviceName);
     
-    CS_DEBUG_PRINTLN("ChronoSense: Initializing " + deviceName);
+    CS_DEBUG_PRINT("ChronoSense: Initializing ");
+    CS_DEBUG_PRINTLN(this->deviceName);
     CS_DEBUG_PRINTLN("Mode: " + String(mode));
     CS_DEBUG_PRINTLN("Channel: " + String(radioChannel));
     
@@ -75,10 +200,15 @@ bool ChronoSense::begin(String deviceName) {
         case CS_WIFI_WEBSOCKET:
         case CS_WIFI_TCP:
             #ifdef ESP32
-            if (wifiSSID.length() == 0) {
+            if (wifiSSID[0] == '\0') {
                 CS_DEBUG_PRINTLN("Error: WiFi credentials not set");
                 return false;
             }
+            if (backgroundConnect) {
+                // loop() finishes the connection; readings are buffered meanwhile
+                startWiFi();
+                return true;
+            }
             return connectWiFi();
             #else
             CS_DEBUG_PRINTLN("Error: WiFi not supported on this board");
@@ -89,12 +219,13 @@ bool ChronoSense::begin(String deviceName) {
         case CS_BLUETOOTH:
             #ifdef ESP32
             bluetooth = new BluetoothSerial();
-            if (!bluetooth->begin(deviceName)) {
+            if (!bluetooth->begin(this->deviceName)) {
                 CS_DEBUG_PRINTLN("Error: Bluetooth initialization failed");
                 return false;
             }
             connected = true;
-            CS_DEBUG_PRINTLN("Bluetooth initialized as: " + deviceName);
+            CS_DEBUG_PRINT("Bluetooth initialized as: ");
+            CS_DEBUG_PRINTLN(this->deviceName);
             #else
             CS_DEBUG_PRINTLN("Error: Bluetooth not supported on this board");
             return false;
@@ -102,9 +233,22 @@ bool ChronoSense::begin(String deviceName) {
             break;
             
         case CS_RADIO_NRF24:
-            // TODO: Implement nRF24L01+ support for Arduino Uno/Nano
-            CS_DEBUG_PRINTLN("Error: nRF24 not implemented yet");
-            return false;
+            #ifdef CS_USE_NRF24
+            if (radio == nullptr) {
+                radio = new ChronoSenseRF24Radio();
+                ownsRadio = true;
+            }
+            #endif
+            if (radio == nullptr) {
+                CS_DEBUG_PRINTLN("Error: No radio (include <RF24.h> in the sketch or call setRadio)");
+                return false;
+            }
+            if (!radio->begin(radioChannel, false)) {
+                CS_DEBUG_PRINTLN("Error: nRF24 initialization failed");
+                return false;
+            }
+            connected = true;
+            CS_DEBUG_PRINTLN("nRF24 initialized, group " + String(radioChannel));
             break;
             
         default:
@@ -119,55 +263,172 @@ bool ChronoSense::begin(String deviceName) {
     return connected;
 }
 
+void ChronoSense::setDeviceName(const char* name) {
+    if (name != this->deviceName) {
+        ChronoSenseUtils::copyString(this->deviceName, sizeof(this->deviceName), name);
+    }
+}
+
+void ChronoSense::setDeviceName(String name) {
+    setDeviceName(name.c_str());
+}
+
+void ChronoSense::setWiFi(const char* ssid, const char* password) {
+    #if defined(ESP32) || defined(ESP8266)
+    ChronoSenseUtils::copyString(this->wifiSSID, sizeof(this->wifiSSID), ssid);
+    ChronoSenseUtils::copyString(this->wifiPassword, sizeof(this->wifiPassword), password);
+    #else
+    (void)ssid;
+    (void)password;
+    #endif
+}
+
 void ChronoSense::setWiFi(String ssid, String password) {
-    this->wifiSSID = ssid;
-    this->wifiPassword = password;
+    setWiFi(ssid.c_str(), password.c_str());
 }
 
-void ChronoSense::setServer(String host, int port) {
-    this->serverHost = host;
+void ChronoSense::setServer(const char* host, int port) {
+    #if defined(ESP32) || defined(ESP8266)
+    ChronoSenseUtils::copyString(this->serverHost, sizeof(this->serverHost), host);
     this->serverPort = port;
+    #else
+    (void)host;
+    (void)port;
+    #endif
+}
+
+void ChronoSense::setServer(String host, int port) {
+    setServer(host.c_str(), port);
 }
 
 bool ChronoSense::connectWiFi() {
     #ifdef ESP32
-    CS_DEBUG_PRINTLN("Connecting to WiFi: " + wifiSSID);
+    startWiFi();
+    while (connectState == CONNECT_CACHED || connectState == CONNECT_SCAN) {
+        delay(50);
+        pollWiFi();
+    }
     
-    WiFi.begin(wifiSSID.c_str(), wifiPassword.c_str());
-    WiFi.setHostname(deviceName.c_str());
+    if (connectState != CONNECT_DONE) {
+        return false;
+    }
     
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-        delay(500);
-        CS_DEBUG_PRINT(".");
-        attempts++;
+    if (mode == CS_WIFI_WEBSOCKET) {
+        return connectWebSocket();
     }
     
+    return connectTCP();
+    #else
+    return false;
+    #endif
+}
+
+#ifdef ESP32
+void ChronoSense::startWiFi() {
+    CS_DEBUG_PRINT("Connecting to WiFi: ");
+    CS_DEBUG_PRINTLN(wifiSSID);
+    
+    connected = false;
+    connectStarted = millis();
+    lastReconnectAttempt = connectStarted;
+    
+    // Hostname must be set before begin(); skip the SDK's own flash writes
+    WiFi.persistent(false);
+    WiFi.mode(WIFI_STA);
+    WiFi.setHostname(deviceName);
+    
+    if (fastConnectEnabled && loadNetworkCache(hashString(wifiSSID))) {
+        // Join the known AP directly: no scan, no DHCP
+        WiFi.config(IPAddress(networkCache.localIP), IPAddress(networkCache.gateway),
+                    IPAddress(networkCache.subnet), IPAddress(networkCache.dns));
+        WiFi.begin(wifiSSID, wifiPassword, networkCache.channel, networkCache.bssid);
+        connectState = CONNECT_CACHED;
+        CS_DEBUG_PRINTLN("Using cached BSSID/channel " + String(networkCache.channel));
+    } else {
+        WiFi.begin(wifiSSID, wifiPassword);
+        connectState = CONNECT_SCAN;
+    }
+}
+
+void ChronoSense::pollWiFi() {
+    unsigned long elapsed = millis() - connectStarted;
+    
     if (WiFi.status() == WL_CONNECTED) {
-        CS_DEBUG_PRINTLN("\nWiFi connected: " + WiFi.localIP().toString());
+        connectDuration = elapsed;
+        fastConnectUsed = (connectState == CONNECT_CACHED);
+        connectState = CONNECT_DONE;
+        CS_DEBUG_PRINTLN("WiFi connected in " + String(connectDuration) + " ms: " + WiFi.localIP().toString());
         
-        if (mode == CS_WIFI_WEBSOCKET) {
-            return connectWebSocket();
+        if (fastConnectEnabled) {
+            uint32_t serverHash = networkCache.serverHash;
+            uint32_t serverIP = networkCache.serverIP;
+            bool sameNetwork = networkCache.magic == CS_NETWORK_CACHE_MAGIC &&
+                               networkCache.ssidHash == hashString(wifiSSID);
+            
+            networkCache.magic = CS_NETWORK_CACHE_MAGIC;
+            networkCache.ssidHash = hashString(wifiSSID);
+            memcpy(networkCache.bssid, WiFi.BSSID(), sizeof(networkCache.bssid));
+            networkCache.channel = WiFi.channel();
+            networkCache.localIP = WiFi.localIP();
+            networkCache.gateway = WiFi.gatewayIP();
+            networkCache.subnet = WiFi.subnetMask();
+            networkCache.dns = WiFi.dnsIP();
+            networkCache.serverHash = sameNetwork ? serverHash : 0;
+            networkCache.serverIP = sameNetwork ? serverIP : 0;
+            saveNetworkCache();
         }
-        
-        connected = true;
-        return true;
-    } else {
-        CS_DEBUG_PRINTLN("\nWiFi connection failed");
+        return;
+    }
+    
+    if (connectState == CONNECT_CACHED && elapsed >= CS_FAST_CONNECT_TIMEOUT) {
+        // Cached parameters failed (AP moved, channel changed, lease gone);
+        // forget them in flash too, or every cold boot retries them
+        CS_DEBUG_PRINTLN("Cached WiFi parameters failed, scanning");
+        eraseNetworkCache();
+        WiFi.disconnect();
+        WiFi.config(IPAddress(), IPAddress(), IPAddress());  // Back to DHCP
+        WiFi.begin(wifiSSID, wifiPassword);
+        connectState = CONNECT_SCAN;
+        return;
+    }
+    
+    if (connectState == CONNECT_SCAN && elapsed >= CS_FAST_CONNECT_TIMEOUT + CS_SCAN_CONNECT_TIMEOUT) {
+        CS_DEBUG_PRINTLN("WiFi connection failed");
+        connectState = CONNECT_FAILED;
         connected = false;
-        if (onErrorCallback != nullptr) {
-            onErrorCallback("WiFi connection failed");
-        }
+        notifyError("WiFi connection failed");
+    }
+}
+
+bool ChronoSense::resolveServer(IPAddress& address) {
+    uint32_t serverHash = hashString(serverHost, serverPort);
+    
+    if (fastConnectEnabled && networkCache.magic == CS_NETWORK_CACHE_MAGIC &&
+        networkCache.serverHash == serverHash && networkCache.serverIP != 0) {
+        address = IPAddress(networkCache.serverIP);
+        return true;
+    }
+    
+    if (!WiFi.hostByName(serverHost, address)) {
         return false;
     }
-    #else
-    return false;
-    #endif
+    
+    if (fastConnectEnabled && networkCache.magic == CS_NETWORK_CACHE_MAGIC) {
+        networkCache.serverHash = serverHash;
+        networkCache.serverIP = address;
+        saveNetworkCache();
+    }
+    return true;
 }
 
-bool ChronoSense::connectWebSocket() {
-    #ifdef ESP32
-    if (serverHost.length() == 0) {
+// Each retry waits twice as long as the last, until one succeeds
+void ChronoSense::backOffReconnect() {
+    reconnectDelay = reconnectDelay >= CS_RECONNECT_MAX_DELAY / 2 ? CS_RECONNECT_MAX_DELAY : reconnectDelay * 2;
+}
+
+bool ChronoSense::startWebSocket() {
+    lastReconnectAttempt = millis();
+    if (serverHost[0] == '\0') {
         CS_DEBUG_PRINTLN("Error: Server host not set");
         return false;
     }
@@ -176,18 +437,30 @@ bool ChronoSense::connectWebSocket() {
         delete webSocket;
     }
     
+    // By name, so the Host header is right; the client resolves it on
+    // every (re)connect, so there is no cached address to go stale
     webSocket = new WebSocketsClient();
-    webSocket->begin(serverHost.c_str(), serverPort, "/");
+    webSocket->begin(serverHost, serverPort, "/");
     webSocket->onEvent(webSocketEventWrapper);
     webSocket->setReconnectInterval(5000);
+    reconnectDelay = CS_RECONNECT_MIN_DELAY;
     
-    CS_DEBUG_PRINTLN("WebSocket configured for: " + serverHost + ":" + String(serverPort));
+    CS_DEBUG_PRINTLN("WebSocket configured for: " + String(serverHost) + ":" + String(serverPort));
+    return true;
+}
+#endif
+
+bool ChronoSense::connectWebSocket() {
+    #ifdef ESP32
+    if (!startWebSocket()) {
+        return false;
+    }
     
     // Wait for connection
     unsigned long startTime = millis();
     while (!connected && (millis() - startTime) < connectionTimeout) {
         webSocket->loop();
-        delay(100);
+        delay(10);
     }
     
     return connected;
@@ -196,137 +469,1070 @@ bool ChronoSense::connectWebSocket() {
     #endif
 }
 
-int ChronoSense::calculateModSum(float values[], int count) {
-    int sum = 0;
+bool ChronoSense::connectTCP() {
+    #ifdef ESP32
+    // A failed lookup is retried from pollTCP() like a failed connect
+    lastReconnectAttempt = millis();
+    IPAddress address;
+    if (serverHost[0] == '\0' || !resolveServer(address)) {
+        CS_DEBUG_PRINTLN("Error: Server host not set or not found");
+        return false;
+    }
+    
+    if (tcpClient == nullptr) {
+        tcpClient = new WiFiClient();
+    }
+    
+    commandLength = 0;
+    commandOverflow = false;
+    
+    if (!tcpClient->connect(address, serverPort)) {
+        CS_DEBUG_PRINTLN("TCP connection failed: " + String(serverHost) + ":" + String(serverPort));
+        forgetServerAddress();  // Resolve again next time
+        connected = false;
+        notifyError("TCP connection failed");
+        return false;
+    }
+    
+    tcpClient->setNoDelay(true);
+    reconnectDelay = CS_RECONNECT_MIN_DELAY;
+    connected = true;
+    CS_DEBUG_PRINTLN("TCP connected to: " + String(serverHost) + ":" + String(serverPort));
+    
+    if (onConnectCallback != nullptr) {
+        onConnectCallback();
+    }
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+size_t ChronoSense::formatCSVData(char* buffer, const int32_t values[], const uint8_t decimals[], int count) {
+    // buffer holds CS_MAX_LINE_LENGTH: enough for ten values at any precision
+    size_t length = 0;
+    
+    // Add sensor values
+    for (int i = 0; i < count; i++) {
+        if (i > 0) buffer[length++] = ',';
+        length += ChronoSenseUtils::formatFixed(buffer + length, values[i], decimals[i]);
+    }
+    
+    // Add checksum if enabled
+    if (checksumEnabled) {
+        buffer[length++] = ',';
+        buffer[length++] = '0' + ChronoSenseUtils::calculateChecksum(values, decimals, count);
+    }
+    
+    buffer[length] = '\0';
+    return length;
+}
+
+bool ChronoSense::sendSensorData(const char* sensorType, const float values[], int count) {
+    if (count <= 0 || count > 10) {
+        return false;
+    }
+    
+    // The only floating point on the send path: one scale per value
+    int32_t scaled[10];
+    for (int i = 0; i < count; i++) {
+        if (!ChronoSenseUtils::toFixed(values[i], channelPrecision[i], scaled[i])) {
+            CS_DEBUG_PRINT("Value not representable for ");
+            CS_DEBUG_PRINTLN(sensorType);
+            return false;
+        }
+    }
+    
+    return sendScaled(sensorType, scaled, channelPrecision, count);
+}
+
+bool ChronoSense::sendSensorData(const char* sensorType, const int values[], int count) {
+    if (count <= 0 || count > 10) {
+        return false;
+    }
+    
+    // Whole numbers (ppm, ADC counts) are sent without decimals
+    static const uint8_t noDecimals[10] = {0};
+    int32_t scaled[10];
+    for (int i = 0; i < count; i++) {
+        scaled[i] = values[i];
+    }
+    
+    return sendScaled(sensorType, scaled, noDecimals, count);
+}
+
+bool ChronoSense::sendFixedPoint(const char* sensorType, const int32_t values[], int count, uint8_t decimals) {
+    if (count <= 0 || count > 10 || decimals > CS_PACKET_MAX_DECIMALS) {
+        return false;
+    }
+    
+    // Values arrive scaled by 10^decimals; the host picks the precision
+    static const int32_t limits[] = {INT32_MAX, INT32_MAX / 10, INT32_MAX / 100, INT32_MAX / 1000};
+    int32_t scaled[10];
     for (int i = 0; i < count; i++) {
-        sum += abs((int)values[i]) % 10;
+        uint8_t to = channelPrecision[i];
+        if (to > decimals && (values[i] > limits[to - decimals] || values[i] < -limits[to - decimals])) {
+            CS_DEBUG_PRINT("Value not representable for ");
+            CS_DEBUG_PRINTLN(sensorType);
+            return false;
+        }
+        scaled[i] = ChronoSenseUtils::rescaleFixed(values[i], decimals, to);
+    }
+    
+    return sendScaled(sensorType, scaled, channelPrecision, count);
+}
+
+bool ChronoSense::sendSensorData(const char* sensorType, float value) {
+    float values[] = {value};
+    return sendSensorData(sensorType, values, 1);
+}
+
+bool ChronoSense::sendSensorData(String sensorType, const float values[], int count) {
+    return sendSensorData(sensorType.c_str(), values, count);
+}
+
+bool ChronoSense::sendSensorData(String sensorType, const int values[], int count) {
+    return sendSensorData(sensorType.c_str(), values, count);
+}
+
+bool ChronoSense::sendSensorData(String sensorType, float value) {
+    return sendSensorData(sensorType.c_str(), value);
+}
+
+bool ChronoSense::sendScaled(const char* sensorType, const int32_t values[], const uint8_t decimals[], int count) {
+    unsigned long allocationsBefore = ChronoSenseHeap::allocationCount();
+    bool sent = transmitReading(sensorType, values, decimals, count);
+    noteHotPath(allocationsBefore);
+    return sent;
+}
+
+bool ChronoSense::transmitReading(const char* sensorType, const int32_t values[], const uint8_t decimals[], int count) {
+    // While (re)connecting, readings can still go into the buffer
+    bool canQueue = bufferEnabled && mode != CS_RADIO_NRF24;
+    if ((!connected && !canQueue) || count <= 0 || count > 10) {
+        return false;
+    }
+    
+    // Validate data if required
+    if (validation >= VALIDATE_BASIC) {
+        if (!validateSensorData(values, decimals, count, sensorType)) {
+            CS_DEBUG_PRINT("Data validation failed for ");
+            CS_DEBUG_PRINTLN(sensorType);
+            return false;
+        }
+    }
+    
+    // Fold into the aggregation window; nothing to send until it fills
+    int32_t averaged[10];
+    if (aggregationWindow > 1) {
+        if (!aggregateReading(values, decimals, count)) {
+            return true;
+        }
+        for (int i = 0; i < count; i++) {
+            int64_t sum = aggregateSum[i];
+            int64_t half = sum < 0 ? -(aggregationWindow / 2) : aggregationWindow / 2;
+            averaged[i] = (int32_t)((sum + half) / aggregationWindow);
+        }
+        values = averaged;
+        aggregateReadings = 0;
+    }
+    
+    // Throttle to the host-requested interval
+    if (transmissionInterval > 0 && lastTransmission != 0 &&
+        (millis() - lastTransmission) < (unsigned long)transmissionInterval) {
+        droppedCount++;
+        return false;
+    }
+    
+    // Radio packs the fixed-point values directly
+    if (mode == CS_RADIO_NRF24) {
+        return sendRadioReading(values, decimals, count);
+    }
+    
+    // Format data
+    char csvData[CS_MAX_LINE_LENGTH];
+    size_t length = formatCSVData(csvData, values, decimals, count);
+    
+    return sendLine(csvData, length);
+}
+
+bool ChronoSense::sendLine(const char* data, size_t length) {
+    // Hold back while offline or the host has not granted credits
+    if (!connected || !canTransmit()) {
+        if (bufferEnabled && length < CS_MAX_LINE_LENGTH) {
+            bufferData(data, length);
+            return true;
+        }
+        if (bufferEnabled) {
+            notifyError("Line too long to buffer");
+        }
+        droppedCount++;
+        return false;
+    }
+    
+    // Transmit
+    if (!transmitString(data, length)) {
+        return false;
+    }
+    
+    // Update last transmission time
+    lastTransmission = millis();
+    
+    // Call callback if set
+    notifyDataSent(data, length);
+    
+    return true;
+}
+
+bool ChronoSense::sendRawCSV(const char* csvData, size_t length) {
+    if (!connected && !bufferEnabled) return false;
+    
+    if (mode == CS_RADIO_NRF24) {
+        // Radio packets carry packed values only
+        notifyError("Raw CSV not supported over nRF24");
+        return false;
+    }
+    
+    // Sent with the caller's length; only buffering copies the line
+    unsigned long allocationsBefore = ChronoSenseHeap::allocationCount();
+    bool sent = sendLine(csvData, length);
+    noteHotPath(allocationsBefore);
+    return sent;
+}
+
+bool ChronoSense::sendRawCSV(const char* csvData) {
+    return sendRawCSV(csvData, strlen(csvData));
+}
+
+bool ChronoSense::sendRawCSV(String csvData) {
+    return sendRawCSV(csvData.c_str(), csvData.length());
+}
+
+// Batches
+static uint32_t batchMask(int count) {
+    return count >= 32 ? 0xFFFFFFFFUL : (1UL << count) - 1;
+}
+
+uint32_t ChronoSense::sendBatch(const ChronoSenseBatch& batch) {
+    return sendColumns(batch.sensorType, batch.values, batch.valueCount, batch.readingCount);
+}
+
+uint32_t ChronoSense::sendBatch(const SensorReading readings[], int count) {
+    if (count <= 0) {
+        return 0;
+    }
+    if (count > CS_MAX_BATCH) {
+        return batchMask(count);
+    }
+    
+    // Runs of the same sensor type go through as one column batch
+    uint32_t failed = 0;
+    int start = 0;
+    while (start < count) {
+        const SensorReading& first = readings[start];
+        int end = start + 1;
+        while (end < count && readings[end].valueCount == first.valueCount &&
+               strcmp(readings[end].sensorType.c_str(), first.sensorType.c_str()) == 0) {
+            end++;
+        }
+        
+        int valueCount = first.valueCount;
+        if (valueCount <= 0 || valueCount > 10) {
+            failed |= batchMask(end - start) << start;
+            start = end;
+            continue;
+        }
+        
+        float columns[10][CS_MAX_BATCH];
+        const float* pointers[10];
+        for (int c = 0; c < valueCount; c++) {
+            for (int r = start; r < end; r++) {
+                columns[c][r - start] = readings[r].values[c];
+            }
+            pointers[c] = columns[c];
+        }
+        
+        failed |= sendColumns(first.sensorType.c_str(), pointers, valueCount, end - start) << start;
+        start = end;
+    }
+    return failed;
+}
+
+uint32_t ChronoSense::sendColumns(const char* sensorType, const float* const columns[], int valueCount, int count) {
+    if (count <= 0) {
+        return 0;
+    }
+    
+    uint32_t failed = batchMask(count);
+    bool canQueue = bufferEnabled && mode != CS_RADIO_NRF24;
+    if ((!connected && !canQueue) || valueCount <= 0 || valueCount > 10 || count > CS_MAX_BATCH) {
+        return failed;
+    }
+    
+    unsigned long allocationsBefore = ChronoSenseHeap::allocationCount();
+    
+    // Earlier buffered readings go out first
+    flushBuffer();
+    
+    // CO2 and accelerometer counts stay integers, as in sendCO2Data and
+    // sendAccelerometerData
+    uint8_t decimals[10];
+    memcpy(decimals, channelPrecision, sizeof(decimals));
+    if (strcmp(sensorType, "CO2") == 0) {
+        decimals[0] = 0;
+    } else if (strcmp(sensorType, "Accelerometer") == 0) {
+        memset(decimals, 0, sizeof(decimals));
+    }
+    
+    // One pass per channel over contiguous values
+    float low[10], high[10];
+    uint8_t invalid[CS_MAX_BATCH];
+    batchLimits(sensorType, valueCount, decimals, low, high);
+    ChronoSenseUtils::validateColumns(columns, low, high, valueCount, count, invalid);
+    
+    // Scale to fixed point column by column; invalid slots become 0
+    static const float scales[] = {1.0f, 10.0f, 100.0f, 1000.0f};
+    int32_t fixed[10][CS_MAX_BATCH];
+    for (int c = 0; c < valueCount; c++) {
+        const float* column = columns[c];
+        float scale = scales[decimals[c] & 0x03];
+        for (int r = 0; r < count; r++) {
+            float value = column[r];
+            float scaled = (invalid[r] ? 0.0f : value) * scale;
+            fixed[c][r] = (int32_t)(scaled + copysignf(0.5f, scaled));
+        }
+    }
+    
+    // Lines collect in one block: a single write, frame or JSON message
+    char block[CS_BATCH_BLOCK_SIZE];
+    size_t blockLength = 0;
+    int blockLines = 0;
+    uint32_t blockRows = 0;
+    uint8_t queuedRows[CS_MAX_BATCH];
+    int queued = 0;
+    int evicted = 0;
+    unsigned int available = credits;
+    if (!flowControlEnabled) {
+        available = count;
+    }
+    
+    for (int r = 0; r < count; r++) {
+        if (invalid[r]) {
+            continue;
+        }
+        
+        int32_t values[10];
+        for (int c = 0; c < valueCount; c++) {
+            values[c] = fixed[c][r];
+        }
+        
+        if (mode == CS_RADIO_NRF24) {
+            if (sendRadioReading(values, decimals, valueCount)) {
+                failed &= ~(1UL << r);
+            }
+            continue;
+        }
+        
+        char line[CS_MAX_LINE_LENGTH];
+        size_t length = formatCSVData(line, values, decimals, valueCount);
+        
+        if (!connected || available == 0) {
+            if (bufferEnabled) {
+                // A full buffer drops its oldest line; once the lines from
+                // before this batch are gone, that is one of ours
+                if (bufferCount == BUFFER_SIZE && bufferCount == queued - evicted) {
+                    failed |= 1UL << queuedRows[evicted++];
+                }
+                bufferData(line, length);
+                queuedRows[queued++] = r;
+                failed &= ~(1UL << r);
+            } else {
+                droppedCount++;
+            }
+            continue;
+        }
+        available--;
+        
+        if (blockLength > 0 && blockLength + length + 2 > sizeof(block)) {
+            if (transmitBlock(block, blockLength, blockLines)) {
+                failed &= ~blockRows;
+            }
+            blockLength = 0;
+            blockLines = 0;
+            blockRows = 0;
+        }
+        memcpy(block + blockLength, line, length);
+        blockLength += length;
+        block[blockLength++] = '\r';
+        block[blockLength++] = '\n';
+        blockLines++;
+        blockRows |= 1UL << r;
+    }
+    
+    if (blockLines > 0 && transmitBlock(block, blockLength, blockLines)) {
+        failed &= ~blockRows;
+    }
+    
+    noteHotPath(allocationsBefore);
+    return failed;
+}
+
+bool ChronoSense::transmitBlock(char* block, size_t length, int lines) {
+    #ifdef ESP32
+    // JSON encodings carry the block's lines as one array
+    char message[CS_BATCH_BLOCK_SIZE + CS_MAX_MESSAGE_LENGTH];
+    size_t messageLength = 0;
+    if (encoding == CS_ENCODING_JSON && (mode == CS_WIFI_WEBSOCKET || mode == CS_WIFI_TCP)) {
+        messageLength = encodeBatchMessage(message, sizeof(message), block, length);
+        if (messageLength == 0) {
+            notifyError("Batch too long for a JSON message");
+            return false;
+        }
+    }
+    #endif
+    
+    if (flowControlEnabled) {
+        credits = credits > (unsigned int)lines ? credits - lines : 0;
+    }
+    if (firstReadingTime == 0) {
+        firstReadingTime = millis();
+    }
+    
+    switch (mode) {
+        case CS_USB_SERIAL:
+            Serial.write((const uint8_t*)block, length);
+            break;
+            
+        case CS_BLUETOOTH:
+            #ifdef ESP32
+            if (bluetooth != nullptr) {
+                bluetooth->write((const uint8_t*)block, length);
+            }
+            #endif
+            break;
+            
+        case CS_WIFI_WEBSOCKET:
+            #ifdef ESP32
+            if (webSocket != nullptr && connected) {
+                if (encoding == CS_ENCODING_CSV) {
+                    // One frame; the trailing CRLF is not needed
+                    webSocket->sendTXT((const uint8_t*)block, length - 2);
+                } else {
+                    webSocket->sendTXT((const uint8_t*)message, messageLength);
+                }
+            }
+            #endif
+            break;
+            
+        case CS_WIFI_TCP:
+            #ifdef ESP32
+            if (tcpClient != nullptr && connected) {
+                if (encoding == CS_ENCODING_CSV) {
+                    tcpClient->write((const uint8_t*)block, length);
+                } else {
+                    tcpClient->write((const uint8_t*)message, messageLength);
+                    tcpClient->println();
+                }
+            }
+            #endif
+            break;
+            
+        default:
+            break;
+    }
+    CS_DEBUG_PRINT("Batch -> ");
+    CS_DEBUG_PRINTLN(lines);
+    lastTransmission = millis();
+    
+    if (onDataSentCallback == nullptr && onDataSentBytesCallback == nullptr) {
+        return true;
+    }
+    
+    // Report each line in place (JSON encoding has turned CR into NUL)
+    size_t start = 0;
+    for (size_t i = 0; i + 1 < length; i++) {
+        if (block[i + 1] == '\n') {
+            notifyDataSent(block + start, i - start);
+            start = i + 2;
+            i++;
+        }
+    }
+    return true;
+}
+
+size_t ChronoSense::encodeBatchMessage(char* buffer, size_t size, char* block, size_t length) {
+    // Lines end in CRLF; ending them in NUL instead lets the document
+    // point into the block rather than copy each line. Returns 0 if the
+    // message does not fit in buffer.
+    StaticJsonDocument<JSON_OBJECT_SIZE(5) + JSON_ARRAY_SIZE(CS_MAX_BATCH)> doc;
+    doc["type"] = "sensor_batch";
+    doc["device"] = (const char*)deviceName;
+    doc["channel"] = radioChannel;
+    JsonArray data = doc.createNestedArray("data");
+    size_t start = 0;
+    for (size_t i = 0; i + 1 < length; i++) {
+        if (block[i] == '\r' && block[i + 1] == '\n') {
+            block[i] = '\0';
+            data.add((const char*)(block + start));
+            start = i + 2;
+            i++;
+        }
+    }
+    doc["timestamp"] = millis();
+    
+    if (measureJson(doc) >= size) {
+        return 0;
+    }
+    return serializeJson(doc, buffer, size);
+}
+
+void ChronoSense::notifyDataSent(const char* data, size_t length) {
+    if (onDataSentBytesCallback != nullptr) {
+        onDataSentBytesCallback(data, length);
+    }
+    if (onDataSentCallback != nullptr) {
+        // data need not be terminated (raw CSV slices)
+        String line;
+        line.reserve(length);
+        for (size_t i = 0; i < length; i++) {
+            line += data[i];
+        }
+        onDataSentCallback(line);
+    }
+}
+
+void ChronoSense::notifyError(const char* error) {
+    if (onErrorBytesCallback != nullptr) {
+        onErrorBytesCallback(error, strlen(error));
+    }
+    if (onErrorCallback != nullptr) {
+        onErrorCallback(String(error));
+    }
+}
+
+bool ChronoSense::aggregateReading(const int32_t values[], const uint8_t decimals[], int count) {
+    bool sameShape = aggregateReadings > 0 && count == aggregateValueCount;
+    for (int i = 0; sameShape && i < count; i++) {
+        sameShape = aggregateDecimals[i] == decimals[i];
+    }
+    
+    if (!sameShape) {
+        for (int i = 0; i < count; i++) {
+            aggregateSum[i] = 0;
+            aggregateDecimals[i] = decimals[i];
+        }
+        aggregateValueCount = count;
+        aggregateReadings = 0;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        aggregateSum[i] += values[i];
+    }
+    aggregateReadings++;
+    
+    return aggregateReadings >= aggregationWindow;
+}
+
+bool ChronoSense::canTransmit() {
+    return !flowControlEnabled || credits > 0;
+}
+
+void ChronoSense::bufferData(const char* data, size_t length) {
+    if (bufferCount == BUFFER_SIZE) {
+        // Full: overwrite the oldest entry
+        bufferIndex = (bufferIndex + 1) % BUFFER_SIZE;
+        bufferCount--;
+        droppedCount++;
+    }
+    
+    int slot = (bufferIndex + bufferCount) % BUFFER_SIZE;
+    memcpy(dataBuffer[slot], data, length);
+    dataBuffer[slot][length] = '\0';
+    dataLength[slot] = length;
+    bufferCount++;
+}
+
+void ChronoSense::flushBuffer() {
+    while (bufferCount > 0 && connected && canTransmit()) {
+        transmitString(dataBuffer[bufferIndex], dataLength[bufferIndex]);
+        lastTransmission = millis();
+        
+        notifyDataSent(dataBuffer[bufferIndex], dataLength[bufferIndex]);
+        
+        bufferIndex = (bufferIndex + 1) % BUFFER_SIZE;
+        bufferCount--;
+    }
+}
+
+size_t ChronoSense::encodeMessage(char* buffer, const char* data, size_t length) {
+    // Fixed-size document and buffers keep this off the heap. Returns 0 if
+    // the line does not fit in one message.
+    char line[CS_MAX_MESSAGE_LENGTH];
+    if (length >= sizeof(line)) {
+        return 0;
+    }
+    memcpy(line, data, length);
+    line[length] = '\0';
+    
+    StaticJsonDocument<192> doc;
+    doc["type"] = "sensor_data";
+    doc["device"] = (const char*)deviceName;
+    doc["channel"] = radioChannel;
+    doc["data"] = (const char*)line;
+    doc["timestamp"] = millis();
+    
+    if (measureJson(doc) >= CS_MAX_MESSAGE_LENGTH) {
+        return 0;
+    }
+    return serializeJson(doc, buffer, CS_MAX_MESSAGE_LENGTH);
+}
+
+bool ChronoSense::transmitString(const char* data, size_t length) {
+    #ifdef ESP32
+    // JSON encodings wrap the line in one fixed-size message
+    char message[CS_MAX_MESSAGE_LENGTH];
+    size_t messageLength = 0;
+    if (encoding == CS_ENCODING_JSON && (mode == CS_WIFI_WEBSOCKET || mode == CS_WIFI_TCP)) {
+        messageLength = encodeMessage(message, data, length);
+        if (messageLength == 0) {
+            notifyError("Line too long for a JSON message");
+            return false;
+        }
+    }
+    #endif
+    
+    if (flowControlEnabled && credits > 0) {
+        credits--;
+    }
+    if (firstReadingTime == 0) {
+        firstReadingTime = millis();
+    }
+    
+    switch (mode) {
+        case CS_USB_SERIAL:
+            Serial.write((const uint8_t*)data, length);
+            Serial.println();
+            break;
+            
+        case CS_WIFI_WEBSOCKET:
+            #ifdef ESP32
+            if (webSocket != nullptr && connected) {
+                if (encoding == CS_ENCODING_CSV) {
+                    webSocket->sendTXT((const uint8_t*)data, length);
+                } else {
+                    webSocket->sendTXT((const uint8_t*)message, messageLength);
+                }
+                
+                CS_DEBUG_PRINT("WebSocket -> ");
+                CS_DEBUG_WRITE(data, length);
+                CS_DEBUG_PRINTLN("");
+            }
+            #endif
+            break;
+            
+        case CS_BLUETOOTH:
+            #ifdef ESP32
+            if (bluetooth != nullptr) {
+                bluetooth->write((const uint8_t*)data, length);
+                bluetooth->println();
+                CS_DEBUG_PRINT("Bluetooth -> ");
+                CS_DEBUG_WRITE(data, length);
+                CS_DEBUG_PRINTLN("");
+            }
+            #endif
+            break;
+            
+        case CS_WIFI_TCP:
+            #ifdef ESP32
+            if (tcpClient != nullptr && connected) {
+                if (encoding == CS_ENCODING_CSV) {
+                    tcpClient->write((const uint8_t*)data, length);
+                } else {
+                    tcpClient->write((const uint8_t*)message, messageLength);
+                }
+                tcpClient->println();
+                CS_DEBUG_PRINT("TCP -> ");
+                CS_DEBUG_WRITE(data, length);
+                CS_DEBUG_PRINTLN("");
+            }
+            #endif
+            break;
+            
+        case CS_RADIO_NRF24:
+            // Readings go through sendRadioReading
+            break;
+    }
+    return true;
+}
+
+// Packet radio
+bool ChronoSense::sendRadioReading(const int32_t values[], const uint8_t decimals[], int count) {
+    if (!packet.add(values, decimals, count)) {
+        // Packet full (or reading shape changed): send it and start another
+        queueRadioPacket();
+        if (!packet.add(values, decimals, count)) {
+            return false;
+        }
+    }
+    if (packet.readingCount() == 1) {
+        packetStarted = millis();
+    }
+    
+    lastTransmission = millis();
+    if (firstReadingTime == 0) {
+        firstReadingTime = lastTransmission;
+    }
+    serviceRadio();
+    
+    if (onDataSentCallback != nullptr || onDataSentBytesCallback != nullptr) {
+        char csvData[CS_MAX_LINE_LENGTH];
+        size_t length = formatCSVData(csvData, values, decimals, count);
+        notifyDataSent(csvData, length);
+    }
+    
+    return true;
+}
+
+void ChronoSense::queueRadioPacket() {
+    if (packet.isEmpty()) {
+        return;
+    }
+    
+    // Only one packet waits outside the radio FIFO; never block the sender
+    if (pendingLength > 0 && !radio->write(pendingPacket, pendingLength)) {
+        droppedCount += pendingPacket[4];
+        CS_DEBUG_PRINTLN("nRF24 queue full, packet dropped");
+    }
+    pendingLength = 0;
+    
+    if (!radio->write(packet.data(), packet.size())) {
+        memcpy(pendingPacket, packet.data(), packet.size());
+        pendingLength = packet.size();
+    }
+    packet.finish();
+}
+
+void ChronoSense::serviceRadio() {
+    if (radio == nullptr) {
+        return;
+    }
+    
+    radio->update();
+    
+    if (pendingLength > 0 && radio->write(pendingPacket, pendingLength)) {
+        pendingLength = 0;
+    }
+    
+    if (!packet.isEmpty() && pendingLength == 0 &&
+        (millis() - packetStarted) >= radioBatchTimeout) {
+        queueRadioPacket();
+    }
+}
+
+void ChronoSense::setRadio(ChronoSenseRadio* radio) {
+    if (ownsRadio && this->radio != nullptr) {
+        delete this->radio;
+    }
+    this->radio = radio;
+    this->ownsRadio = false;
+}
+
+void ChronoSense::setRadioBatchTimeout(unsigned long milliseconds) {
+    this->radioBatchTimeout = milliseconds;
+}
+
+// Fast startup
+void ChronoSense::enableFastConnect(bool enable) {
+    this->fastConnectEnabled = enable;
+}
+
+void ChronoSense::enableBackgroundConnect(bool enable) {
+    this->backgroundConnect = enable;
+}
+
+void ChronoSense::clearNetworkCache() {
+    #ifdef ESP32
+    eraseNetworkCache();
+    #endif
+}
+
+bool ChronoSense::usedFastConnect() {
+    return fastConnectUsed;
+}
+
+unsigned long ChronoSense::getConnectTime() {
+    return connectDuration;
+}
+
+unsigned long ChronoSense::getTimeToFirstReading() {
+    return firstReadingTime;
+}
+
+// Control channel
+void ChronoSense::loop() {
+    #ifdef ESP32
+    if (mode == CS_WIFI_WEBSOCKET || mode == CS_WIFI_TCP) {
+        if (connectState == CONNECT_CACHED || connectState == CONNECT_SCAN) {
+            pollWiFi();
+            if (connectState == CONNECT_DONE) {
+                // An existing WebSocket client reconnects by itself
+                if (mode == CS_WIFI_TCP) {
+                    connectTCP();
+                } else if (webSocket == nullptr) {
+                    startWebSocket();
+                }
+            }
+        } else if (connectState == CONNECT_DONE && WiFi.status() != WL_CONNECTED) {
+            // Lost the AP: rejoin through the cached path first
+            CS_DEBUG_PRINTLN("WiFi lost, reconnecting");
+            connected = false;
+            startWiFi();
+        } else if (connectState == CONNECT_FAILED && (millis() - lastReconnectAttempt) >= 5000) {
+            startWiFi();
+        } else if (connectState == CONNECT_DONE && mode == CS_WIFI_WEBSOCKET && webSocket == nullptr &&
+                   (millis() - lastReconnectAttempt) >= reconnectDelay) {
+            backOffReconnect();
+            startWebSocket();
+        }
+    }
+    if (mode == CS_WIFI_WEBSOCKET && webSocket != nullptr) {
+        webSocket->loop();
+    }
+    if (mode == CS_WIFI_TCP) {
+        pollTCP();
+    }
+    #endif
+    
+    if (mode == CS_RADIO_NRF24) {
+        serviceRadio();
+    }
+    
+    flushBuffer();
+}
+
+bool ChronoSense::handleCommand(const char* command, size_t length) {
+    ControlCommand cmd;
+    char reply[96];
+    if (!ChronoSenseUtils::parseControlCommand(command, length, cmd)) {
+        sendControlReply("NAK");
+        return false;
+    }
+    
+    switch (cmd.type) {
+        case CS_CMD_INTERVAL:
+            setTransmissionInterval(cmd.value);
+            snprintf(reply, sizeof(reply), "ACK INTERVAL %d", transmissionInterval);
+            sendControlReply(reply);
+            break;
+            
+        case CS_CMD_AGGREGATE:
+            setAggregationWindow(cmd.value);
+            snprintf(reply, sizeof(reply), "ACK AGGREGATE %d", aggregationWindow);
+            sendControlReply(reply);
+            break;
+            
+        case CS_CMD_BUFFER:
+            enableDataBuffering(cmd.value != 0);
+            sendControlReply(bufferEnabled ? "ACK BUFFER ON" : "ACK BUFFER OFF");
+            break;
+            
+        case CS_CMD_PRECISION:
+            if (cmd.channel < 0) {
+                setPrecision(cmd.value);
+                snprintf(reply, sizeof(reply), "ACK PRECISION %d", channelPrecision[0]);
+            } else {
+                setChannelPrecision(cmd.channel, cmd.value);
+                snprintf(reply, sizeof(reply), "ACK PRECISION %d %d", cmd.channel,
+                         channelPrecision[cmd.channel]);
+            }
+            sendControlReply(reply);
+            break;
+            
+        case CS_CMD_ENCODING:
+            setEncoding((ChronoSenseEncoding)cmd.value);
+            sendControlReply(encoding == CS_ENCODING_CSV ? "ACK ENCODING CSV" : "ACK ENCODING JSON");
+            break;
+            
+        case CS_CMD_CREDIT:
+            grantCredits(cmd.value);
+            snprintf(reply, sizeof(reply), "ACK CREDIT %u", credits);
+            sendControlReply(reply);
+            break;
+            
+        case CS_CMD_FLOW:
+            enableFlowControl(cmd.value != 0);
+            sendControlReply(flowControlEnabled ? "ACK FLOW ON" : "ACK FLOW OFF");
+            break;
+            
+        case CS_CMD_STATUS:
+            snprintf(reply, sizeof(reply), "STATUS credits=%u buffered=%d dropped=%lu interval=%d aggregate=%d",
+                     credits, bufferCount, droppedCount, transmissionInterval, aggregationWindow);
+            sendControlReply(reply);
+            break;
+            
+        default:
+            sendControlReply("NAK");
+            return false;
     }
-    return sum % 10;
+    
+    return true;
 }
 
-int ChronoSense::calculateModSum(int values[], int count) {
-    int sum = 0;
-    for (int i = 0; i < count; i++) {
-        sum += abs(values[i]) % 10;
+void ChronoSense::handleCommandPayload(const uint8_t* payload, size_t length) {
+    // A single message may carry several commands separated by ';' or newlines
+    size_t start = 0;
+    for (size_t i = 0; i <= length; i++) {
+        if (i == length || payload[i] == ';' || payload[i] == '\n' || payload[i] == '\r') {
+            if (i > start) {
+                handleCommand((const char*)payload + start, i - start);
+            }
+            start = i + 1;
+        }
     }
-    return sum % 10;
 }
 
-String ChronoSense::formatCSVData(String sensorType, float values[], int count) {
-    String csv = "";
-    
-    // Add sensor values
-    for (int i = 0; i < count; i++) {
-        if (i > 0) csv += ",";
-        csv += String(values[i], 1);
-    }
-    
-    // Add checksum if enabled
-    if (checksumEnabled) {
-        int checksum = calculateModSum(values, count);
-        csv += "," + String(checksum);
+void ChronoSense::sendControlReply(const char* reply) {
+    // Replies bypass flow control so the host always sees them
+    (void)reply;  // Unused without a network transport or CS_DEBUG
+    #ifdef ESP32
+    if (mode == CS_WIFI_WEBSOCKET && webSocket != nullptr && connected) {
+        if (encoding == CS_ENCODING_CSV) {
+            webSocket->sendTXT(reply);
+        } else {
+            StaticJsonDocument<192> doc;
+            doc["type"] = "control";
+            doc["device"] = (const char*)deviceName;
+            doc["data"] = reply;
+            
+            char message[CS_MAX_MESSAGE_LENGTH];
+            size_t messageLength = serializeJson(doc, message, sizeof(message));
+            webSocket->sendTXT((const uint8_t*)message, messageLength);
+        }
+    } else if (mode == CS_WIFI_TCP && tcpClient != nullptr && connected) {
+        tcpClient->println(reply);
     }
+    #endif
     
-    return csv;
+    CS_DEBUG_PRINT("Control <- ");
+    CS_DEBUG_PRINTLN(reply);
 }
 
-bool ChronoSense::sendSensorData(String sensorType, float values[], int count) {
-    if (!connected || count <= 0 || count > 10) {
-        return false;
-    }
-    
-    // Validate data if required
-    if (validation >= VALIDATE_BASIC) {
-        if (!validateSensorData(values, count, sensorType)) {
-            CS_DEBUG_PRINTLN("Data validation failed for " + sensorType);
-            return false;
+#ifdef ESP32
+void ChronoSense::pollTCP() {
+    if (tcpClient == nullptr || !tcpClient->connected()) {
+        if (connected) {
+            connected = false;
+            CS_DEBUG_PRINTLN("TCP Disconnected");
+            if (onDisconnectCallback != nullptr) {
+                onDisconnectCallback();
+            }
         }
+        if (WiFi.status() == WL_CONNECTED && (millis() - lastReconnectAttempt) >= reconnectDelay) {
+            backOffReconnect();
+            connectTCP();
+        }
+        return;
     }
     
-    // Format data
-    String csvData = formatCSVData(sensorType, values, count);
-    
-    // Transmit
-    transmitString(csvData);
-    
-    // Update last transmission time
-    lastTransmission = millis();
-    
-    // Call callback if set
-    if (onDataSentCallback != nullptr) {
-        onDataSentCallback(csvData);
+    while (tcpClient->available() > 0) {
+        int c = tcpClient->read();
+        if (c < 0) {
+            break;
+        }
+        
+        if (c == '\n' || c == '\r') {
+            if (!commandOverflow && commandLength > 0) {
+                handleCommandPayload((const uint8_t*)commandBuffer, commandLength);
+            }
+            commandLength = 0;
+            commandOverflow = false;
+        } else if (commandLength < COMMAND_BUFFER_SIZE) {
+            commandBuffer[commandLength++] = (char)c;
+        } else {
+            // Over-long line: discard it up to the next newline
+            commandOverflow = true;
+        }
     }
-    
-    return true;
 }
+#endif
 
-bool ChronoSense::sendSensorData(String sensorType, float value) {
-    float values[] = {value};
-    return sendSensorData(sensorType, values, 1);
+void ChronoSense::setTransmissionInterval(int milliseconds) {
+    this->transmissionInterval = constrain(milliseconds, 0, 3600000);
 }
 
-bool ChronoSense::sendRawCSV(String csvData) {
-    if (!connected) return false;
-    
-    transmitString(csvData);
-    lastTransmission = millis();
-    
-    if (onDataSentCallback != nullptr) {
-        onDataSentCallback(csvData);
+void ChronoSense::enableDataBuffering(bool enable) {
+    this->bufferEnabled = enable;
+}
+
+void ChronoSense::setAggregationWindow(int readings) {
+    this->aggregationWindow = constrain(readings, 1, MAX_AGGREGATION_WINDOW);
+    this->aggregateReadings = 0;
+}
+
+void ChronoSense::setPrecision(int decimals) {
+    for (int i = 0; i < 10; i++) {
+        setChannelPrecision(i, decimals);
     }
-    
-    return true;
 }
 
-void ChronoSense::transmitString(String data) {
-    switch (mode) {
-        case CS_USB_SERIAL:
-            Serial.println(data);
-            break;
-            
-        case CS_WIFI_WEBSOCKET:
-            #ifdef ESP32
-            if (webSocket != nullptr && connected) {
-                // Create JSON message
-                DynamicJsonDocument doc(300);
-                doc["type"] = "sensor_data";
-                doc["device"] = deviceName;
-                doc["channel"] = radioChannel;
-                doc["data"] = data;
-                doc["timestamp"] = millis();
-                
-                String message;
-                serializeJson(doc, message);
-                webSocket->sendTXT(message);
-                
-                CS_DEBUG_PRINTLN("WebSocket -> " + data);
-            }
-            #endif
-            break;
-            
-        case CS_BLUETOOTH:
-            #ifdef ESP32
-            if (bluetooth != nullptr) {
-                bluetooth->println(data);
-                CS_DEBUG_PRINTLN("Bluetooth -> " + data);
-            }
-            #endif
-            break;
-            
-        case CS_WIFI_TCP:
-            // TODO: Implement TCP socket transmission
-            break;
-            
-        case CS_RADIO_NRF24:
-            // TODO: Implement nRF24L01+ transmission
-            break;
+void ChronoSense::setChannelPrecision(int channel, int decimals) {
+    if (channel < 0 || channel >= 10) {
+        return;
+    }
+    this->channelPrecision[channel] = constrain(decimals, 0, CS_PACKET_MAX_DECIMALS);
+}
+
+void ChronoSense::setEncoding(ChronoSenseEncoding encoding) {
+    this->encoding = encoding;
+}
+
+void ChronoSense::enableFlowControl(bool enable) {
+    this->flowControlEnabled = enable;
+}
+
+void ChronoSense::grantCredits(unsigned int credits) {
+    // Granting credits implies the host wants flow control
+    this->flowControlEnabled = true;
+    this->credits += credits;
+    if (this->credits > MAX_CREDITS) {
+        this->credits = MAX_CREDITS;
     }
+    flushBuffer();
+}
+
+unsigned int ChronoSense::getCredits() {
+    return credits;
+}
+
+int ChronoSense::getBufferedCount() {
+    return bufferCount;
+}
+
+unsigned long ChronoSense::getDroppedCount() {
+    return droppedCount;
 }
 
 // Specialized sensor methods
 bool ChronoSense::sendCO2Data(int co2, float temperature, float humidity) {
-    float values[] = {(float)co2, temperature, humidity};
-    return sendSensorData("CO2", values, 3);
+    // CO2 stays an integer; only temperature and humidity are scaled
+    int32_t values[3];
+    uint8_t decimals[] = {0, channelPrecision[1], channelPrecision[2]};
+    values[0] = co2;
+    if (!ChronoSenseUtils::toFixed(temperature, decimals[1], values[1]) ||
+        !ChronoSenseUtils::toFixed(humidity, decimals[2], values[2])) {
+        return false;
+    }
+    return sendScaled("CO2", values, decimals, 3);
+}
+
+bool ChronoSense::sendCO2Data(int co2, int32_t temperature, int32_t humidity, uint8_t decimals) {
+    // Temperature and humidity arrive scaled by 10^decimals
+    int32_t values[3];
+    uint8_t channelDecimals[] = {0, channelPrecision[1], channelPrecision[2]};
+    values[0] = co2;
+    values[1] = ChronoSenseUtils::rescaleFixed(temperature, decimals, channelDecimals[1]);
+    values[2] = ChronoSenseUtils::rescaleFixed(humidity, decimals, channelDecimals[2]);
+    return sendScaled("CO2", values, channelDecimals, 3);
 }
 
 bool ChronoSense::sendTemperatureData(float temperature) {
@@ -334,7 +1540,7 @@ bool ChronoSense::sendTemperatureData(float temperature) {
 }
 
 bool ChronoSense::sendAccelerometerData(int x, int y, int z) {
-    float values[] = {(float)x, (float)y, (float)z};
+    int values[] = {x, y, z};
     return sendSensorData("Accelerometer", values, 3);
 }
 
@@ -365,6 +1571,9 @@ bool ChronoSense::isConnected() {
             return bluetooth != nullptr && bluetooth->connected();
             #endif
             break;
+            
+        case CS_RADIO_NRF24:
+            return radio != nullptr && connected;
     }
     return connected;
 }
@@ -397,12 +1606,18 @@ String ChronoSense::getConnectionStatus() {
             return bluetooth && bluetooth->connected() ? "Bluetooth Connected" : "Bluetooth Disconnected";
             #endif
             break;
+            
+        case CS_RADIO_NRF24:
+            if (radio == nullptr || !connected) {
+                return "nRF24 Not Initialized";
+            }
+            return "nRF24 Ready (" + String(radio->getTxFailures()) + " failed)";
     }
     return "Unknown";
 }
 
 String ChronoSense::getDeviceInfo() {
-    String info = "Device: " + deviceName + "\n";
+    String info = "Device: " + String(deviceName) + "\n";
     info += "Mode: ";
     
     switch (mode) {
@@ -440,32 +1655,121 @@ String ChronoSense::getVersion() {
     return String(CHRONOSENSE_ARDUINO_VERSION);
 }
 
-bool ChronoSense::validateSensorData(float values[], int count, String sensorType) {
-    for (int i = 0; i < count; i++) {
-        if (isnan(values[i]) || isinf(values[i])) {
-            return false;
-        }
+// Event callbacks
+void ChronoSense::onConnect(void (*callback)()) {
+    this->onConnectCallback = callback;
+}
+
+void ChronoSense::onDisconnect(void (*callback)()) {
+    this->onDisconnectCallback = callback;
+}
+
+void ChronoSense::onDataSent(void (*callback)(const char* data, size_t length)) {
+    this->onDataSentBytesCallback = callback;
+}
+
+void ChronoSense::onError(void (*callback)(const char* error, size_t length)) {
+    this->onErrorBytesCallback = callback;
+}
+
+void ChronoSense::onDataSent(void (*callback)(String data)) {
+    this->onDataSentCallback = callback;
+}
+
+void ChronoSense::onError(void (*callback)(String error)) {
+    this->onErrorCallback = callback;
+}
+
+// Heap accounting
+void ChronoSense::noteHotPath(unsigned long allocationsBefore) {
+    unsigned long allocations = ChronoSenseHeap::allocationCount();
+    if (allocations != allocationsBefore) {
+        heapStats.hotPathAllocations += allocations - allocationsBefore;
+        CS_DEBUG_PRINTLN("Warning: send path allocated on the heap");
+    }
+    
+    size_t freeHeap = ChronoSenseHeap::freeHeap();
+    if (freeHeap != 0 && (heapStats.minFreeHeap == 0 || freeHeap < heapStats.minFreeHeap)) {
+        heapStats.minFreeHeap = freeHeap;
     }
+}
+
+ChronoSenseHeapStats ChronoSense::getHeapStats() {
+    ChronoSenseHeapStats stats = heapStats;
+    stats.allocations = ChronoSenseHeap::allocationCount() - heapStats.allocations;
+    return stats;
+}
+
+void ChronoSense::resetHeapStats() {
+    // allocations holds the baseline count; getHeapStats reports the delta
+    heapStats.allocations = ChronoSenseHeap::allocationCount();
+    heapStats.hotPathAllocations = 0;
+    heapStats.minFreeHeap = 0;
+}
+
+// Sensor-specific limits in whole units
+struct SensorLimits {
+    const char* sensorType;
+    int count;
+    int32_t low[3];
+    int32_t high[3];
+};
+
+static const SensorLimits sensorLimits[] = {
+    // CO2: 0-50000 ppm, Temp: -40 to 85°C, Humidity: 0-100%
+    {"CO2", 3, {0, -40, 0}, {50000, 85, 100}},
+    // Temperature: -40 to 125°C
+    {"Temperature", 1, {-40}, {125}},
+    // Distance: 0 to 400 cm
+    {"Distance", 1, {0}, {400}}
+};
+
+bool ChronoSense::validateSensorData(const int32_t values[], const uint8_t decimals[], int count, const char* sensorType) {
+    static const int32_t scales[] = {1, 10, 100, 1000};
     
-    // Sensor-specific validation
-    if (sensorType == "CO2" && count >= 3) {
-        // CO2: 0-50000 ppm, Temp: -40 to 85°C, Humidity: 0-100%
-        return (values[0] >= 0 && values[0] <= 50000) &&
-               (values[1] >= -40 && values[1] <= 85) &&
-               (values[2] >= 0 && values[2] <= 100);
+    for (unsigned int s = 0; s < sizeof(sensorLimits) / sizeof(sensorLimits[0]); s++) {
+        const SensorLimits& limits = sensorLimits[s];
+        if (strcmp(sensorType, limits.sensorType) != 0 || count < limits.count) {
+            continue;
+        }
+        
+        // Compare in the values' own fixed-point scale
+        for (int i = 0; i < limits.count; i++) {
+            int32_t scale = scales[decimals[i] & 0x03];
+            if (values[i] < limits.low[i] * scale || values[i] > limits.high[i] * scale) {
+                return false;
+            }
+        }
+        return true;
     }
     
-    if (sensorType == "Temperature") {
-        // Temperature: -40 to 125°C
-        return values[0] >= -40 && values[0] <= 125;
+    return true;
+}
+
+void ChronoSense::batchLimits(const char* sensorType, int valueCount, const uint8_t decimals[],
+                              float low[], float high[]) {
+    // Always bound by what fits in int32 at each channel's precision
+    static const float representable[] = {2147483000.0f, 214748300.0f, 21474830.0f, 2147483.0f};
+    for (int i = 0; i < valueCount; i++) {
+        high[i] = representable[decimals[i] & 0x03];
+        low[i] = -high[i];
     }
     
-    if (sensorType == "Distance") {
-        // Distance: 0 to 400 cm
-        return values[0] >= 0 && values[0] <= 400;
+    if (validation < VALIDATE_BASIC) {
+        return;
     }
     
-    return true;
+    for (unsigned int s = 0; s < sizeof(sensorLimits) / sizeof(sensorLimits[0]); s++) {
+        const SensorLimits& limits = sensorLimits[s];
+        if (strcmp(sensorType, limits.sensorType) != 0 || valueCount < limits.count) {
+            continue;
+        }
+        for (int i = 0; i < limits.count; i++) {
+            low[i] = limits.low[i];
+            high[i] = limits.high[i];
+        }
+        return;
+    }
 }
 
 // WebSocket event handler
@@ -486,16 +1790,16 @@ void ChronoSense::handleWebSocketEvent(WStype_t type, uint8_t* payload, size_t l
             }
             break;
             
-        case WStype_CONNECTED:
+        case WStype_CONNECTED: {
             connected = true;
             CS_DEBUG_PRINTLN("WebSocket Connected");
             
             // Send device identification
             DynamicJsonDocument doc(200);
             doc["type"] = "device_info";
-            doc["device"] = deviceName;
+            doc["device"] = (const char*)deviceName;
             doc["channel"] = radioChannel;
-            doc["version"] = getVersion();
+            doc["version"] = CHRONOSENSE_ARDUINO_VERSION;
             
             String message;
             serializeJson(doc, message);
@@ -505,17 +1809,20 @@ void ChronoSense::handleWebSocketEvent(WStype_t type, uint8_t* payload, size_t l
                 onConnectCallback();
             }
             break;
+        }
             
         case WStype_TEXT:
-            CS_DEBUG_PRINTLN("Received: " + String((char*)payload));
+            // Host control commands
+            handleCommandPayload(payload, length);
             break;
             
         case WStype_ERROR:
             connected = false;
             CS_DEBUG_PRINTLN("WebSocket Error");
-            if (onErrorCallback != nullptr) {
-                onErrorCallback("WebSocket error");
-            }
+            notifyError("WebSocket error");
+            break;
+            
+        default:
             break;
     }
 }
@@ -539,10 +1846,208 @@ namespace ChronoSenseUtils {
         return sum % 10;
     }
     
+    int calculateChecksum(const int32_t values[], const uint8_t decimals[], int count) {
+        static const int32_t scales[] = {1, 10, 100, 1000};
+        int sum = 0;
+        for (int i = 0; i < count; i++) {
+            // Ones digit of the integer part, as for float values
+            int32_t whole = values[i] / scales[decimals[i] & 0x03];
+            sum += (whole < 0 ? -whole : whole) % 10;
+        }
+        return sum % 10;
+    }
+    
+    bool toFixed(float value, uint8_t decimals, int32_t& result) {
+        static const float scales[] = {1.0f, 10.0f, 100.0f, 1000.0f};
+        
+        // NaN fails both comparisons, so this also rejects NaN and Inf
+        float scaled = value * scales[decimals & 0x03];
+        if (!(scaled > -2147483000.0f && scaled < 2147483000.0f)) {
+            return false;
+        }
+        result = (int32_t)(scaled >= 0 ? scaled + 0.5f : scaled - 0.5f);
+        return true;
+    }
+    
+    int32_t rescaleFixed(int32_t value, uint8_t from, uint8_t to) {
+        // Change decimal places, rounding half away from zero
+        static const int32_t powers[] = {1, 10, 100, 1000};
+        from &= 0x03;
+        to &= 0x03;
+        if (to >= from) {
+            return value * powers[to - from];
+        }
+        int32_t divisor = powers[from - to];
+        int32_t half = value < 0 ? -(divisor / 2) : divisor / 2;
+        return (value + half) / divisor;
+    }
+    
+    int formatFixed(char* buffer, int32_t value, uint8_t decimals) {
+        // Digits are produced in reverse, then copied out
+        char digits[12];
+        int n = 0;
+        uint32_t magnitude = value < 0 ? 0 - (uint32_t)value : (uint32_t)value;
+        
+        do {
+            digits[n++] = '0' + magnitude % 10;
+            magnitude /= 10;
+            if (n == decimals) {
+                digits[n++] = '.';
+            }
+        } while (magnitude > 0 || (decimals > 0 && n < decimals + 2));
+        
+        int pos = 0;
+        if (value < 0) {
+            buffer[pos++] = '-';
+        }
+        while (n > 0) {
+            buffer[pos++] = digits[--n];
+        }
+        buffer[pos] = '\0';
+        return pos;
+    }
+    
     bool validateRange(float value, float min, float max) {
         return value >= min && value <= max && !isnan(value) && !isinf(value);
     }
     
+    void validateColumns(const float* const values[], const float low[], const float high[],
+                         int channels, int count, uint8_t failed[]) {
+        // Branch-free so the compiler can vectorize the inner loop. NaN
+        // fails both comparisons; Inf is outside any finite bound.
+        for (int r = 0; r < count; r++) {
+            failed[r] = 0;
+        }
+        for (int c = 0; c < channels; c++) {
+            const float* column = values[c];
+            float lo = low[c];
+            float hi = high[c];
+            for (int r = 0; r < count; r++) {
+                failed[r] |= !((column[r] >= lo) & (column[r] <= hi));
+            }
+        }
+    }
+    
+    // Case-insensitive match of a token against an upper-case keyword
+    static bool tokenEquals(const char* token, size_t length, const char* keyword) {
+        size_t i = 0;
+        for (; i < length; i++) {
+            char c = token[i];
+            if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+            if (keyword[i] == '\0' || c != keyword[i]) {
+                return false;
+            }
+        }
+        return keyword[i] == '\0';
+    }
+    
+    static bool parseLong(const char* token, size_t length, long& value) {
+        if (length == 0 || length > 9) {
+            return false;
+        }
+        value = 0;
+        for (size_t i = 0; i < length; i++) {
+            if (token[i] < '0' || token[i] > '9') {
+                return false;
+            }
+            value = value * 10 + (token[i] - '0');
+        }
+        return true;
+    }
+    
+    bool parseControlCommand(const char* text, size_t length, ControlCommand& command) {
+        command.type = CS_CMD_INVALID;
+        command.value = 0;
+        command.channel = -1;
+        
+        // Split into "<VERB> [ARG] [ARG]" without copying
+        const char* tokens[3];
+        size_t tokenLengths[3];
+        int tokenCount = 0;
+        size_t pos = 0;
+        while (true) {
+            while (pos < length && text[pos] == ' ') pos++;
+            if (pos == length) break;
+            if (tokenCount == 3) return false;
+            tokens[tokenCount] = text + pos;
+            tokenLengths[tokenCount] = 0;
+            while (pos < length && text[pos] != ' ') { pos++; tokenLengths[tokenCount]++; }
+            tokenCount++;
+        }
+        if (tokenCount == 0) {
+            return false;
+        }
+        
+        const char* verb = tokens[0];
+        size_t verbLength = tokenLengths[0];
+        const char* arg = tokenCount > 1 ? tokens[1] : text + length;
+        size_t argLength = tokenCount > 1 ? tokenLengths[1] : 0;
+        
+        // Only PRECISION takes a second argument (channel, then digits)
+        if (tokenCount == 3) {
+            long channel;
+            if (!tokenEquals(verb, verbLength, "PRECISION") ||
+                !parseLong(tokens[1], tokenLengths[1], channel) || channel >= 10) {
+                return false;
+            }
+            command.channel = channel;
+            arg = tokens[2];
+            argLength = tokenLengths[2];
+        }
+        
+        ControlCommandType type = CS_CMD_INVALID;
+        if (tokenEquals(verb, verbLength, "INTERVAL")) type = CS_CMD_INTERVAL;
+        else if (tokenEquals(verb, verbLength, "AGGREGATE")) type = CS_CMD_AGGREGATE;
+        else if (tokenEquals(verb, verbLength, "BUFFER")) type = CS_CMD_BUFFER;
+        else if (tokenEquals(verb, verbLength, "PRECISION")) type = CS_CMD_PRECISION;
+        else if (tokenEquals(verb, verbLength, "ENCODING")) type = CS_CMD_ENCODING;
+        else if (tokenEquals(verb, verbLength, "CREDIT")) type = CS_CMD_CREDIT;
+        else if (tokenEquals(verb, verbLength, "FLOW")) type = CS_CMD_FLOW;
+        else if (tokenEquals(verb, verbLength, "STATUS")) type = CS_CMD_STATUS;
+        else return false;
+        
+        long value = 0;
+        switch (type) {
+            case CS_CMD_STATUS:
+                if (argLength != 0) return false;
+                break;
+                
+            case CS_CMD_BUFFER:
+            case CS_CMD_FLOW:
+                if (tokenEquals(arg, argLength, "ON") || tokenEquals(arg, argLength, "1")) value = 1;
+                else if (tokenEquals(arg, argLength, "OFF") || tokenEquals(arg, argLength, "0")) value = 0;
+                else return false;
+                break;
+                
+            case CS_CMD_ENCODING:
+                if (tokenEquals(arg, argLength, "JSON")) value = CS_ENCODING_JSON;
+                else if (tokenEquals(arg, argLength, "CSV")) value = CS_ENCODING_CSV;
+                else return false;
+                break;
+                
+            default:
+                if (!parseLong(arg, argLength, value)) return false;
+                break;
+        }
+        
+        command.type = type;
+        command.value = value;
+        return true;
+    }
+    
+    size_t copyString(char* dest, size_t capacity, const char* src) {
+        // Truncates to fit; dest is always terminated
+        size_t length = 0;
+        if (src != nullptr) {
+            while (length + 1 < capacity && src[length] != '\0') {
+                dest[length] = src[length];
+                length++;
+            }
+        }
+        dest[length] = '\0';
+        return length;
+    }
+    
     String formatTimestamp() {
         unsigned long ms = millis();
         unsigned long seconds = ms / 1000;
@@ -560,6 +2065,119 @@ namespace ChronoSenseUtils {
     }
 }
 
+// Heap accounting
+#ifdef __AVR__
+// avr-libc heap bounds; must be declared outside the namespace to link
+extern char __heap_start;
+extern char* __brkval;
+#endif
+
+namespace ChronoSenseHeap {
+    static volatile unsigned long allocations = 0;
+    
+    void recordAllocation() {
+        allocations++;
+    }
+    
+    unsigned long allocationCount() {
+        return allocations;
+    }
+    
+    size_t freeHeap() {
+        #if defined(ESP32) || defined(ESP8266)
+        return ESP.getFreeHeap();
+        #elif defined(__AVR__)
+        // Gap between the top of the heap and the stack
+        char top;
+        return &top - (__brkval == 0 ? &__heap_start : __brkval);
+        #else
+        return 0;
+        #endif
+    }
+}
+
+#ifdef CS_TRACK_HEAP
+// Count every heap allocation, String's and the core's included. Needs
+// -Wl,--wrap=malloc,--wrap=realloc,--wrap=calloc at link time.
+extern "C" {
+    void* __real_malloc(size_t size);
+    void* __real_realloc(void* ptr, size_t size);
+    void* __real_calloc(size_t count, size_t size);
+    
+    void* __wrap_malloc(size_t size) {
+        ChronoSenseHeap::recordAllocation();
+        return __real_malloc(size);
+    }
+    
+    void* __wrap_realloc(void* ptr, size_t size) {
+        ChronoSenseHeap::recordAllocation();
+        return __real_realloc(ptr, size);
+    }
+    
+    void* __wrap_calloc(size_t count, size_t size) {
+        ChronoSenseHeap::recordAllocation();
+        return __real_calloc(count, size);
+    }
+}
+
+// Route operator new through the wrapped malloc, including where the C++
+// runtime is a shared library the linker cannot wrap
+void* operator new(size_t size) {
+    return malloc(size);
+}
+
+void* operator new[](size_t size) {
+    return malloc(size);
+}
+
+void operator delete(void* ptr) {
+    free(ptr);
+}
+
+void operator delete[](void* ptr) {
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t /* size */) {
+    free(ptr);
+}
+
+void operator delete[](void* ptr, size_t /* size */) {
+    free(ptr);
+}
+#endif
+
+// Sensor reading
+SensorReading::SensorReading(String type) {
+    sensorType = type;
+    clear();
+}
+
+void SensorReading::addValue(float value) {
+    if (valueCount < 10) {
+        values[valueCount++] = value;
+    }
+}
+
+void SensorReading::addValue(int value) {
+    addValue((float)value);
+}
+
+void SensorReading::clear() {
+    valueCount = 0;
+    timestamp = millis();
+    isValid = false;
+}
+
+bool SensorReading::validate() {
+    // Range limits per sensor type are applied by ChronoSense::sendBatch
+    isValid = valueCount > 0;
+    for (int i = 0; i < valueCount && isValid; i++) {
+        isValid = ChronoSenseUtils::validateRange(values[i], -3.4e38f, 3.4e38f);
+    }
+    return isValid;
+}
+
 // Specialized sensor class implementations
 CO2Sensor::CO2Sensor(ChronoSense* cs) {
     chronoSense = cs;
@@ -570,7 +2188,7 @@ bool CO2Sensor::sendReading(int co2, float temperature, float humidity) {
 }
 
 bool CO2Sensor::sendReading(int co2) {
-    float values[] = {(float)co2};
+    int values[] = {co2};
     return chronoSense->sendSensorData("CO2", values, 1);
 }
 
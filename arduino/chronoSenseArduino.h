@@ -9,9 +9,14 @@
  * - WiFi TCP (to ChronoSense receiver)
  * - Bluetooth Serial
  * - USB Serial (micro:bit compatible)
+ * - nRF24L01+ radio (Arduino Uno/Nano, see chronoSenseRadio.h)
  * 
  * Compatible with ChronoSense checksum validation
  * 
+ * Network hosts can adjust rate, aggregation, buffering, precision and
+ * encoding at run time, and throttle the device by granting credits,
+ * using one-line text commands over WebSocket or TCP.
+ * 
  * Author: St. Mary's Edenderry
  * Version: 1.0
  * Date: November 2025
@@ -26,6 +31,7 @@
 #ifdef ESP32
     #include <WiFi.h>
     #include <WebSocketsClient.h>
+    #include <Preferences.h>
 #elif defined(ESP8266)
     #include <ESP8266WiFi.h>
     #include <WebSocketsClient.h>
@@ -38,6 +44,8 @@
 
 #include <ArduinoJson.h>
 
+#include "chronoSenseRadio.h"
+
 // Transmission modes
 enum ChronoSenseMode {
     CS_USB_SERIAL,        // USB serial (like micro:bit)
@@ -55,49 +63,229 @@ enum ValidationLevel {
     VALIDATE_FULL         // All validation methods
 };
 
+// Message encodings for WebSocket/TCP transmission
+enum ChronoSenseEncoding {
+    CS_ENCODING_JSON,     // JSON envelope with device/channel/timestamp
+    CS_ENCODING_CSV       // Bare CSV line (same as USB serial)
+};
+
+// Host-to-device control commands (see ChronoSense::handleCommand)
+enum ControlCommandType {
+    CS_CMD_INVALID,
+    CS_CMD_INTERVAL,      // INTERVAL <ms>       minimum time between transmissions
+    CS_CMD_AGGREGATE,     // AGGREGATE <n>       average n readings per transmission
+    CS_CMD_BUFFER,        // BUFFER ON|OFF       queue readings instead of dropping
+    CS_CMD_PRECISION,     // PRECISION [ch] <d>  decimal places, all channels or one
+    CS_CMD_ENCODING,      // ENCODING JSON|CSV   WebSocket/TCP message encoding
+    CS_CMD_CREDIT,        // CREDIT <n>          grant n transmission credits
+    CS_CMD_FLOW,          // FLOW ON|OFF         enable credit-based flow control
+    CS_CMD_STATUS         // STATUS              report flow control state
+};
+
+struct ControlCommand {
+    ControlCommandType type;
+    long value;
+    int channel;          // PRECISION only; -1 = all channels
+};
+
+// Heap usage seen by the library (see ChronoSense::getHeapStats)
+struct ChronoSenseHeapStats {
+    unsigned long allocations;         // Allocations recorded since reset
+    unsigned long hotPathAllocations;  // Allocations made inside send calls
+    size_t minFreeHeap;                // Lowest free heap sampled (0 if unknown)
+};
+
+// Structure-of-arrays batch: values[c] points to readingCount
+// consecutive values of channel c
+struct ChronoSenseBatch {
+    const char* sensorType;
+    int valueCount;             // Channels per reading (1-10)
+    int readingCount;           // 1-CS_MAX_BATCH
+    const float* values[10];
+};
+
+class SensorReading;
+
+// Fixed capacities for configuration strings and CSV lines. A line holds
+// ten values of up to 13 characters ("-2147483.648,"), the checksum and
+// the terminator.
+#define CS_MAX_NAME_LENGTH 32
+#define CS_MAX_SSID_LENGTH 32
+#define CS_MAX_PASSWORD_LENGTH 64
+#define CS_MAX_HOST_LENGTH 64
+#define CS_MAX_LINE_LENGTH (10 * 13 + 4)
+#define CS_MAX_MESSAGE_LENGTH 256
+
+// WiFi connect timeouts: cached AP/channel first, then a full scan
+#define CS_FAST_CONNECT_TIMEOUT 3000
+#define CS_SCAN_CONNECT_TIMEOUT 10000
+
+// Server reconnect backoff: doubles after each failed attempt
+#define CS_RECONNECT_MIN_DELAY 1000
+#define CS_RECONNECT_MAX_DELAY 30000
+
+// Ring buffer entries. This sizes a member of ChronoSense, so a sketch
+// cannot change it: the library's own files would still see the default
+// and disagree about the class layout.
+#ifdef CS_BUFFER_SIZE
+    #error "CS_BUFFER_SIZE is fixed per platform and cannot be overridden"
+#endif
+#ifdef __AVR__
+    #define CS_BUFFER_SIZE 2
+#else
+    #define CS_BUFFER_SIZE 10
+#endif
+
+// Readings per batch. Failures come back as a 32-bit bitmap, so at most
+// 32. Like the block size below, only a build flag reaches the library.
+#ifndef CS_MAX_BATCH
+    #ifdef __AVR__
+        #define CS_MAX_BATCH 4
+    #else
+        #define CS_MAX_BATCH 32
+    #endif
+#endif
+#if CS_MAX_BATCH > 32
+    #error "CS_MAX_BATCH cannot exceed 32 (sendBatch returns a 32-bit bitmap)"
+#endif
+
+// Batch text handed to a transport in one write or message. Must hold
+// at least one line and its CRLF.
+#ifndef CS_BATCH_BLOCK_SIZE
+    #ifdef __AVR__
+        #define CS_BATCH_BLOCK_SIZE (CS_MAX_LINE_LENGTH + 2)
+    #else
+        #define CS_BATCH_BLOCK_SIZE 512
+    #endif
+#endif
+#if CS_BATCH_BLOCK_SIZE < CS_MAX_LINE_LENGTH + 2
+    #error "CS_BATCH_BLOCK_SIZE must hold a CS_MAX_LINE_LENGTH line and its CRLF"
+#endif
+
 class ChronoSense {
 private:
     // Configuration
     ChronoSenseMode mode;
-    String deviceName;
+    char deviceName[CS_MAX_NAME_LENGTH + 1];
     int radioChannel;
     bool checksumEnabled;
     ValidationLevel validation;
     int transmissionInterval;
+    int aggregationWindow;
+    uint8_t channelPrecision[10];   // Decimal places per value (0-3)
+    ChronoSenseEncoding encoding;
     
     // Network settings
-    String wifiSSID;
-    String wifiPassword;
-    String serverHost;
+    #if defined(ESP32) || defined(ESP8266)
+    char wifiSSID[CS_MAX_SSID_LENGTH + 1];
+    char wifiPassword[CS_MAX_PASSWORD_LENGTH + 1];
+    char serverHost[CS_MAX_HOST_LENGTH + 1];
     int serverPort;
+    #endif
     
     // Communication objects
     #ifdef ESP32
     WebSocketsClient* webSocket;
     BluetoothSerial* bluetooth;
+    WiFiClient* tcpClient;
     #endif
     
     // Status tracking
     bool connected;
     unsigned long lastTransmission;
+    unsigned long lastReconnectAttempt;
+    unsigned long reconnectDelay;
     unsigned long connectionTimeout;
+    unsigned long droppedCount;
     
-    // Data buffering
-    static const int BUFFER_SIZE = 10;
-    String dataBuffer[BUFFER_SIZE];
+    // Data buffering (ring buffer, oldest entry at bufferIndex)
+    static const int BUFFER_SIZE = CS_BUFFER_SIZE;
+    char dataBuffer[BUFFER_SIZE][CS_MAX_LINE_LENGTH];
+    uint8_t dataLength[BUFFER_SIZE];
     int bufferIndex;
+    int bufferCount;
     bool bufferEnabled;
     
+    // Reading aggregation
+    static const int MAX_AGGREGATION_WINDOW = 60;
+    int64_t aggregateSum[10];
+    uint8_t aggregateDecimals[10];
+    int aggregateValueCount;
+    int aggregateReadings;
+    
+    // Credit-based flow control
+    static const unsigned int MAX_CREDITS = 1000;
+    bool flowControlEnabled;
+    unsigned int credits;
+    
+    // Packet radio (nRF24L01+)
+    ChronoSenseRadio* radio;
+    bool ownsRadio;
+    ChronoSensePacketWriter packet;
+    uint8_t pendingPacket[CS_RADIO_PAYLOAD_SIZE];
+    uint8_t pendingLength;
+    unsigned long packetStarted;
+    unsigned long radioBatchTimeout;
+    
+    // Incoming control line (TCP)
+    #if defined(ESP32) || defined(ESP8266)
+    static const int COMMAND_BUFFER_SIZE = 64;
+    char commandBuffer[COMMAND_BUFFER_SIZE];
+    int commandLength;
+    bool commandOverflow;
+    #endif
+    
+    // Heap accounting
+    ChronoSenseHeapStats heapStats;
+    
+    // WiFi connection state (ESP32)
+    enum ConnectState {
+        CONNECT_IDLE,
+        CONNECT_CACHED,       // Joining the cached BSSID/channel with static IP
+        CONNECT_SCAN,         // Full scan and DHCP
+        CONNECT_DONE,
+        CONNECT_FAILED
+    };
+    ConnectState connectState;
+    bool fastConnectEnabled;
+    bool backgroundConnect;
+    bool fastConnectUsed;
+    unsigned long connectStarted;
+    unsigned long connectDuration;
+    unsigned long firstReadingTime;
+    
     // Internal methods
-    int calculateModSum(float values[], int count);
-    int calculateModSum(int values[], int count);
-    bool validateSensorData(float values[], int count, String sensorType);
-    void bufferData(String data);
+    bool validateSensorData(const int32_t values[], const uint8_t decimals[], int count, const char* sensorType);
+    void bufferData(const char* data, size_t length);
     void flushBuffer();
-    String formatCSVData(String sensorType, float values[], int count);
-    void transmitString(String data);
+    size_t formatCSVData(char* buffer, const int32_t values[], const uint8_t decimals[], int count);
+    bool sendScaled(const char* sensorType, const int32_t values[], const uint8_t decimals[], int count);
+    bool transmitReading(const char* sensorType, const int32_t values[], const uint8_t decimals[], int count);
+    bool sendLine(const char* data, size_t length);
+    uint32_t sendColumns(const char* sensorType, const float* const columns[], int valueCount, int count);
+    void batchLimits(const char* sensorType, int valueCount, const uint8_t decimals[], float low[], float high[]);
+    bool transmitBlock(char* block, size_t length, int lines);
+    size_t encodeBatchMessage(char* buffer, size_t size, char* block, size_t length);
+    void noteHotPath(unsigned long allocationsBefore);
+    bool aggregateReading(const int32_t values[], const uint8_t decimals[], int count);
+    bool canTransmit();
+    bool transmitString(const char* data, size_t length);
+    size_t encodeMessage(char* buffer, const char* data, size_t length);
+    void sendControlReply(const char* reply);
+    void notifyDataSent(const char* data, size_t length);
+    void notifyError(const char* error);
+    void handleCommandPayload(const uint8_t* payload, size_t length);
+    bool sendRadioReading(const int32_t values[], const uint8_t decimals[], int count);
+    void queueRadioPacket();
+    void serviceRadio();
     
     #ifdef ESP32
+    void pollTCP();
+    void startWiFi();
+    void pollWiFi();
+    bool startWebSocket();
+    bool resolveServer(IPAddress& address);
+    void backOffReconnect();
     void handleWebSocketEvent(WStype_t type, uint8_t* payload, size_t length);
     static void webSocketEventWrapper(WStype_t type, uint8_t* payload, size_t length);
     #endif
@@ -109,30 +297,89 @@ public:
     
     // Basic setup
     bool begin();
+    bool begin(const char* deviceName);
     bool begin(String deviceName);
+    void setDeviceName(const char* name);
     void setDeviceName(String name);
     void setRadioChannel(int channel);
     
     // Network configuration (ESP32/ESP8266 only)
+    void setWiFi(const char* ssid, const char* password);
     void setWiFi(String ssid, String password);
+    void setServer(const char* host, int port);
     void setServer(String host, int port);
     bool connectWiFi();
     bool connectWebSocket();
+    bool connectTCP();
+    
+    // Fast startup (ESP32): reuse the last AP, channel, IP settings and
+    // (TCP) server address, and optionally connect in the background from
+    // loop(). A server address that fails to connect is forgotten.
+    void enableFastConnect(bool enable = true);
+    void enableBackgroundConnect(bool enable = true);
+    void clearNetworkCache();
+    bool usedFastConnect();
+    unsigned long getConnectTime();         // ms from begin() to WiFi up
+    unsigned long getTimeToFirstReading();  // ms from boot to first send
+    
+    // Radio configuration (CS_RADIO_NRF24 only)
+    void setRadio(ChronoSenseRadio* radio);
+    void setRadioBatchTimeout(unsigned long milliseconds);
     
     // Transmission settings
     void enableChecksum(bool enable = true);
     void setValidationLevel(ValidationLevel level);
     void setTransmissionInterval(int milliseconds);
     void enableDataBuffering(bool enable = true);
+    void setAggregationWindow(int readings);
+    void setPrecision(int decimals);
+    void setChannelPrecision(int channel, int decimals);
+    void setEncoding(ChronoSenseEncoding encoding);
+    
+    // Host control channel and flow control
+    void loop();
+    bool handleCommand(const char* command, size_t length);
+    void enableFlowControl(bool enable = true);
+    void grantCredits(unsigned int credits);
+    unsigned int getCredits();
+    int getBufferedCount();
+    unsigned long getDroppedCount();
     
-    // Data transmission methods
+    // Data transmission methods (the const char* forms never allocate)
+    bool sendSensorData(const char* sensorType, float value);
+    bool sendSensorData(const char* sensorType, const float values[], int count);
+    bool sendSensorData(const char* sensorType, const int values[], int count);
+    // Raw lines of any length go straight out; only lines shorter than
+    // CS_MAX_LINE_LENGTH can be buffered, and a JSON message holds at
+    // most CS_MAX_MESSAGE_LENGTH bytes. csvData need not be terminated.
+    bool sendRawCSV(const char* csvData, size_t length);
+    bool sendRawCSV(const char* csvData);
     bool sendSensorData(String sensorType, float value);
-    bool sendSensorData(String sensorType, float values[], int count);
-    bool sendSensorData(String sensorType, int values[], int count);
+    bool sendSensorData(String sensorType, const float values[], int count);
+    bool sendSensorData(String sensorType, const int values[], int count);
+    
+    // Fixed-point values, each scaled by 10^decimals, rescaled to the
+    // channel precisions. Integer readings and fixed-point values never
+    // touch floating point.
+    bool sendFixedPoint(const char* sensorType, const int32_t values[], int count, uint8_t decimals);
+    
+    // Batches: one validation pass and one transport write for many
+    // readings. Bit i of the result is set if reading i was not sent
+    // (buffered readings count as sent). Batches skip aggregation and the
+    // interval throttle but honour flow control credits. Lines match the
+    // single-reading calls: CO2 and Accelerometer counts stay integers, as
+    // in sendCO2Data and sendAccelerometerData.
+    // WebSocket CSV sends one frame of CRLF-separated lines; JSON
+    // encodings send one message per block:
+    //   {"type":"sensor_batch","device":...,"channel":...,
+    //    "data":["line",...],"timestamp":...}
+    uint32_t sendBatch(const ChronoSenseBatch& batch);
+    uint32_t sendBatch(const SensorReading readings[], int count);
     bool sendRawCSV(String csvData);
     
     // Specialized sensor methods
     bool sendCO2Data(int co2, float temperature, float humidity);
+    bool sendCO2Data(int co2, int32_t temperature, int32_t humidity, uint8_t decimals);
     bool sendTemperatureData(float temperature);
     bool sendAccelerometerData(int x, int y, int z);
     bool sendDistanceData(float distance);
@@ -145,6 +392,10 @@ public:
     int getSignalStrength(); // WiFi RSSI or Bluetooth signal
     unsigned long getLastTransmissionTime();
     
+    // Heap usage on the send path
+    ChronoSenseHeapStats getHeapStats();
+    void resetHeapStats();
+    
     // Utility methods
     void printDiagnostics();
     void resetConnection();
@@ -153,6 +404,8 @@ public:
     // Event callbacks (optional)
     void onConnect(void (*callback)());
     void onDisconnect(void (*callback)());
+    void onDataSent(void (*callback)(const char* data, size_t length));
+    void onError(void (*callback)(const char* error, size_t length));
     void onDataSent(void (*callback)(String data));
     void onError(void (*callback)(String error));
     
@@ -162,6 +415,8 @@ private:
     void (*onDisconnectCallback)();
     void (*onDataSentCallback)(String data);
     void (*onErrorCallback)(String error);
+    void (*onDataSentBytesCallback)(const char* data, size_t length);
+    void (*onErrorBytesCallback)(const char* error, size_t length);
     
     // Static instance for WebSocket callback
     static ChronoSense* instance;
@@ -176,7 +431,7 @@ public:
     unsigned long timestamp;
     bool isValid;
     
-    SensorReading(String type);
+    SensorReading(String type = "");
     void addValue(float value);
     void addValue(int value);
     void clear();
@@ -215,9 +470,28 @@ public:
 namespace ChronoSenseUtils {
     int calculateChecksum(float values[], int count);
     int calculateChecksum(int values[], int count);
+    int calculateChecksum(const int32_t values[], const uint8_t decimals[], int count);
+    int formatFixed(char* buffer, int32_t value, uint8_t decimals);
+    bool toFixed(float value, uint8_t decimals, int32_t& result);
+    int32_t rescaleFixed(int32_t value, uint8_t from, uint8_t to);
     bool validateRange(float value, float min, float max);
+    void validateColumns(const float* const values[], const float low[], const float high[],
+                         int channels, int count, uint8_t failed[]);
     String formatTimestamp();
     String formatDeviceInfo(String deviceName, String sensorType);
+    bool parseControlCommand(const char* text, size_t length, ControlCommand& command);
+    size_t copyString(char* dest, size_t capacity, const char* src);
+}
+
+// Heap accounting. With CS_TRACK_HEAP defined the library wraps malloc,
+// realloc and calloc and counts every call, so String, ArduinoJson and
+// operator new are all seen. The sketch must then link with
+// -Wl,--wrap=malloc,--wrap=realloc,--wrap=calloc (compiler.c.elf.extra_flags
+// in platform.local.txt, or build_flags under PlatformIO).
+namespace ChronoSenseHeap {
+    void recordAllocation();
+    unsigned long allocationCount();
+    size_t freeHeap();
 }
 
 // Version information
@@ -228,9 +502,11 @@ namespace ChronoSenseUtils {
 #ifdef CS_DEBUG
 #define CS_DEBUG_PRINT(x) Serial.print(x)
 #define CS_DEBUG_PRINTLN(x) Serial.println(x)
+#define CS_DEBUG_WRITE(data, length) Serial.write((const uint8_t*)(data), length)
 #else
 #define CS_DEBUG_PRINT(x)
 #define CS_DEBUG_PRINTLN(x)
+#define CS_DEBUG_WRITE(data, length)
 #endif
 
 #endif // CHRONOSENSE_ARDUINO_H
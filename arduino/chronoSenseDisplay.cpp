@@ -0,0 +1,264 @@
+/*
+ * chronoSenseDisplay.cpp
+ *
+ * Implementation of incremental SSD1306 OLED updates
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#include "chronoSenseDisplay.h"
+
+// SSD1306 control bytes and addressing commands
+#define SSD1306_CONTROL_COMMAND 0x00
+#define SSD1306_CONTROL_DATA 0x40
+#define SSD1306_MEMORY_MODE 0x20
+#define SSD1306_COLUMN_ADDRESS 0x21
+#define SSD1306_PAGE_ADDRESS 0x22
+
+ChronoSenseDisplay::ChronoSenseDisplay(ChronoSenseI2C* bus, uint8_t address, uint8_t height) {
+    this->bus = bus;
+    this->address = address;
+    this->pages = constrain(height / 8, 1, CS_DISPLAY_MAX_PAGES);
+    this->chunkSize = CS_DISPLAY_CHUNK_SIZE;
+    this->framebuffer = nullptr;
+    this->pending = false;
+    this->windowPage = -1;
+    this->windowEnd = 0;
+    this->frameBytes = 0;
+    memset(shadow, 0, sizeof(shadow));
+    memset(dirtyStart, 0, sizeof(dirtyStart));
+    memset(dirtyEnd, 0, sizeof(dirtyEnd));
+    resetStats();
+}
+
+bool ChronoSenseDisplay::begin(const uint8_t* framebuffer) {
+    this->framebuffer = framebuffer;
+    memcpy(shadow, framebuffer, CS_DISPLAY_WIDTH * pages);
+    memset(dirtyStart, 0, sizeof(dirtyStart));
+    memset(dirtyEnd, 0, sizeof(dirtyEnd));
+    pending = false;
+    windowPage = -1;
+    setChunkSize(chunkSize);  // Fit the bus's write buffer
+
+    // Partial windows rely on horizontal addressing
+    uint8_t commands[] = {SSD1306_MEMORY_MODE, 0x00};
+    return sendCommands(commands, sizeof(commands));
+}
+
+void ChronoSenseDisplay::commit() {
+    if (framebuffer == nullptr) {
+        return;
+    }
+
+    for (uint8_t p = 0; p < pages; p++) {
+        const uint8_t* row = framebuffer + p * CS_DISPLAY_WIDTH;
+        const uint8_t* shown = shadow + p * CS_DISPLAY_WIDTH;
+
+        int first = 0;
+        while (first < CS_DISPLAY_WIDTH && row[first] == shown[first]) {
+            first++;
+        }
+        if (first == CS_DISPLAY_WIDTH) {
+            continue;
+        }
+        int last = CS_DISPLAY_WIDTH - 1;
+        while (row[last] == shown[last]) {
+            last--;
+        }
+
+        // Merge with whatever is still queued for this page
+        if (dirtyStart[p] < dirtyEnd[p]) {
+            if (dirtyStart[p] < first) first = dirtyStart[p];
+            if (dirtyEnd[p] > last + 1) last = dirtyEnd[p] - 1;
+        }
+        if (p == windowPage && (dirtyStart[p] != first || dirtyEnd[p] != last + 1)) {
+            windowPage = -1;
+        }
+        dirtyStart[p] = first;
+        dirtyEnd[p] = last + 1;
+        pending = true;
+    }
+}
+
+bool ChronoSenseDisplay::update() {
+    if (!pending) {
+        return false;
+    }
+
+    unsigned long busBefore = bus->getBusTime();
+    unsigned long bytesBefore = bus->getBytesWritten();
+
+    uint8_t p = 0;
+    while (dirtyStart[p] >= dirtyEnd[p]) {
+        p++;
+    }
+
+    uint8_t start = dirtyStart[p];
+    uint8_t count = dirtyEnd[p] - start;
+    if (count > chunkSize) {
+        count = chunkSize;
+    }
+
+    bool ok = true;
+    if (windowPage != p || windowEnd != dirtyEnd[p]) {
+        // Open a window over the rest of this span; later chunks of the
+        // same span continue from the panel's address pointer
+        uint8_t commands[] = {
+            SSD1306_COLUMN_ADDRESS, start, (uint8_t)(dirtyEnd[p] - 1),
+            SSD1306_PAGE_ADDRESS, p, p
+        };
+        ok = sendCommands(commands, sizeof(commands));
+        windowPage = ok ? p : -1;
+        windowEnd = dirtyEnd[p];
+    }
+
+    if (ok) {
+        uint8_t data[CS_DISPLAY_CHUNK_SIZE * 4 + 1];
+        const uint8_t* source = framebuffer + p * CS_DISPLAY_WIDTH + start;
+        data[0] = SSD1306_CONTROL_DATA;
+        memcpy(data + 1, source, count);
+        ok = bus->write(address, data, count + 1);
+
+        if (ok) {
+            // Record exactly what went out, even if the sketch has drawn
+            // over it since commit(); the next commit picks that up
+            memcpy(shadow + p * CS_DISPLAY_WIDTH + start, source, count);
+            dirtyStart[p] = start + count;
+            stats.chunks++;
+        } else {
+            windowPage = -1;
+        }
+    }
+
+    if (!ok) {
+        stats.errors++;
+    }
+
+    // Estimated from bytes and clock, like ChronoSenseI2C::getBusTime()
+    unsigned long busTime = bus->getBusTime() - busBefore;
+    if (busTime > stats.maxBusTime) {
+        stats.maxBusTime = busTime;
+    }
+    frameBytes += bus->getBytesWritten() - bytesBefore;
+
+    pending = false;
+    for (uint8_t i = 0; i < pages; i++) {
+        if (dirtyStart[i] < dirtyEnd[i]) {
+            pending = true;
+            break;
+        }
+    }
+    if (!pending) {
+        finishFrame();
+    }
+    return pending;
+}
+
+void ChronoSenseDisplay::finishFrame() {
+    stats.frames++;
+    stats.lastFrameBytes = frameBytes;
+    if (frameBytes > stats.maxFrameBytes) {
+        stats.maxFrameBytes = frameBytes;
+    }
+    frameBytes = 0;
+}
+
+void ChronoSenseDisplay::flush() {
+    unsigned long errorsBefore = stats.errors;
+    while (update()) {
+        if (stats.errors - errorsBefore > 3) {
+            break;  // Panel not answering; leave the rest queued
+        }
+    }
+}
+
+void ChronoSenseDisplay::invalidate() {
+    // Make every byte differ from the framebuffer so commit() resends it
+    if (framebuffer != nullptr) {
+        for (int i = 0; i < CS_DISPLAY_WIDTH * pages; i++) {
+            shadow[i] = ~framebuffer[i];
+        }
+    }
+    windowPage = -1;
+}
+
+void ChronoSenseDisplay::setChunkSize(uint8_t bytes) {
+    // One byte of each write goes to the data control byte
+    size_t limit = bus->maxWriteLength() - 1;
+    if (limit > CS_DISPLAY_CHUNK_SIZE * 4) {
+        limit = CS_DISPLAY_CHUNK_SIZE * 4;
+    }
+    this->chunkSize = constrain(bytes, 1, limit);
+}
+
+void ChronoSenseDisplay::resetStats() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool ChronoSenseDisplay::sendCommands(const uint8_t* commands, uint8_t length) {
+    uint8_t data[8];
+    data[0] = SSD1306_CONTROL_COMMAND;
+    memcpy(data + 1, commands, length);
+    return bus->write(address, data, length + 1);
+}
+
+// Simulated panel
+ChronoSenseSSD1306Simulator::ChronoSenseSSD1306Simulator() {
+    memset(ram, 0, sizeof(ram));
+    this->columnStart = 0;
+    this->columnEnd = CS_DISPLAY_WIDTH - 1;
+    this->pageStart = 0;
+    this->pageEnd = CS_DISPLAY_MAX_PAGES - 1;
+    this->column = 0;
+    this->page = 0;
+}
+
+bool ChronoSenseSSD1306Simulator::transmit(uint8_t address, const uint8_t* data, size_t length) {
+    if (address != CS_DISPLAY_ADDRESS || length == 0) {
+        return false;
+    }
+
+    if (data[0] == SSD1306_CONTROL_DATA) {
+        for (size_t i = 1; i < length; i++) {
+            ram[page * CS_DISPLAY_WIDTH + column] = data[i];
+            if (column < columnEnd) {
+                column++;
+            } else {
+                // End of the window row: wrap to the next page in range
+                column = columnStart;
+                page = page < pageEnd ? page + 1 : pageStart;
+            }
+        }
+        return true;
+    }
+
+    if (data[0] != SSD1306_CONTROL_COMMAND) {
+        return false;
+    }
+
+    size_t i = 1;
+    while (i < length) {
+        uint8_t command = data[i++];
+        if (command == SSD1306_MEMORY_MODE && i < length) {
+            i++;  // Only horizontal mode is simulated
+        } else if (command == SSD1306_COLUMN_ADDRESS && i + 1 < length) {
+            columnStart = data[i] % CS_DISPLAY_WIDTH;
+            columnEnd = data[i + 1] % CS_DISPLAY_WIDTH;
+            column = columnStart;
+            i += 2;
+        } else if (command == SSD1306_PAGE_ADDRESS && i + 1 < length) {
+            pageStart = data[i] % CS_DISPLAY_MAX_PAGES;
+            pageEnd = data[i + 1] % CS_DISPLAY_MAX_PAGES;
+            page = pageStart;
+            i += 2;
+        }
+    }
+    return true;
+}
+
+size_t ChronoSenseSSD1306Simulator::receive(uint8_t /* address */, uint8_t* /* data */, size_t /* length */) {
+    // Write-only panel
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * chronoSenseDisplay.h
+ *
+ * Incremental SSD1306 OLED updates for ChronoSense sketches
+ *
+ * - ChronoSenseDisplay: pushes only the changed parts of a framebuffer,
+ *   a small chunk per update() call, so a redraw never holds up the loop
+ * - ChronoSenseSSD1306Simulator: simulated panel on a ChronoSenseI2C bus
+ *   for host tests
+ *
+ * Drawing stays with Adafruit_SSD1306/GFX: draw into its buffer as usual,
+ * then call commit() instead of display(). The framebuffer uses the
+ * SSD1306 layout: one byte per column per 8-pixel page.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#ifndef CHRONOSENSE_DISPLAY_H
+#define CHRONOSENSE_DISPLAY_H
+
+#include <Arduino.h>
+#include "chronoSenseI2C.h"
+
+#define CS_DISPLAY_ADDRESS 0x3C
+#define CS_DISPLAY_WIDTH 128
+#define CS_DISPLAY_MAX_PAGES 8
+
+// Data bytes per update() call: about 0.8 ms of bus time at 400 kHz
+#define CS_DISPLAY_CHUNK_SIZE 32
+
+struct ChronoSenseDisplayStats {
+    unsigned long frames;          // Frames completely pushed
+    unsigned long lastFrameBytes;  // Bus bytes for the last frame, commands included
+    unsigned long maxFrameBytes;
+    unsigned long chunks;
+    unsigned long maxBusTime;      // Most bus time in one update(), estimated microseconds
+    unsigned long errors;
+};
+
+class ChronoSenseDisplay {
+private:
+    ChronoSenseI2C* bus;
+    uint8_t address;
+    uint8_t pages;
+    uint8_t chunkSize;
+    const uint8_t* framebuffer;
+
+    // What the panel currently shows, and the column span [start, end)
+    // of each page that still differs from the framebuffer
+    uint8_t shadow[CS_DISPLAY_WIDTH * CS_DISPLAY_MAX_PAGES];
+    uint8_t dirtyStart[CS_DISPLAY_MAX_PAGES];
+    uint8_t dirtyEnd[CS_DISPLAY_MAX_PAGES];
+    bool pending;
+
+    // Address window left open on the panel by the previous chunk
+    int8_t windowPage;
+    uint8_t windowEnd;
+
+    unsigned long frameBytes;
+    ChronoSenseDisplayStats stats;
+
+    bool sendCommands(const uint8_t* commands, uint8_t length);
+    void finishFrame();
+
+public:
+    ChronoSenseDisplay(ChronoSenseI2C* bus, uint8_t address = CS_DISPLAY_ADDRESS, uint8_t height = 64);
+
+    // Call once the panel shows framebuffer (e.g. right after the
+    // Adafruit begin() and display()); later commits are diffed from it.
+    bool begin(const uint8_t* framebuffer);
+
+    // Queue everything that changed since the panel was last updated.
+    // Cheap: no bus traffic happens here.
+    void commit();
+
+    // Push at most one chunk. Returns true while changes remain queued.
+    bool update();
+
+    // Push all queued changes now (blocking)
+    void flush();
+
+    // Resend the whole framebuffer on the next commit
+    void invalidate();
+
+    void setChunkSize(uint8_t bytes);
+    bool isBusy() { return pending; }
+    ChronoSenseDisplayStats getStats() { return stats; }
+    void resetStats();
+};
+
+// Simulated SSD1306 GDDRAM. Applies the addressing commands
+// (0x20 memory mode, 0x21 column range, 0x22 page range) and data writes
+// in horizontal addressing mode; other commands are accepted and ignored.
+class ChronoSenseSSD1306Simulator : public ChronoSenseI2C {
+private:
+    uint8_t ram[CS_DISPLAY_WIDTH * CS_DISPLAY_MAX_PAGES];
+    uint8_t columnStart, columnEnd, pageStart, pageEnd;
+    uint8_t column, page;
+
+protected:
+    bool transmit(uint8_t address, const uint8_t* data, size_t length);
+    size_t receive(uint8_t address, uint8_t* data, size_t length);
+
+public:
+    ChronoSenseSSD1306Simulator();
+
+    size_t maxWriteLength() { return 128; }
+    const uint8_t* getRam() { return ram; }
+};
+
+#endif // CHRONOSENSE_DISPLAY_H
@@ -0,0 +1,90 @@
+/*
+ * chronoSenseI2C.cpp
+ *
+ * Implementation of the ChronoSense I2C transaction layer
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#include "chronoSenseI2C.h"
+
+ChronoSenseI2C::ChronoSenseI2C() {
+    this->clockHz = CS_I2C_DEFAULT_CLOCK;
+    resetStats();
+}
+
+void ChronoSenseI2C::account(size_t length, bool ok) {
+    // Start + address byte + data bytes (8 bits + ack each) + stop
+    unsigned long bits = 2 + 9 * (length + 1);
+    transactions++;
+    busMicros += (bits * 1000000UL + clockHz - 1) / clockHz;
+    if (!ok) {
+        errors++;
+    }
+}
+
+bool ChronoSenseI2C::write(uint8_t address, const uint8_t* data, size_t length) {
+    bool ok = transmit(address, data, length);
+    bytesWritten += length;
+    account(length, ok);
+    return ok;
+}
+
+size_t ChronoSenseI2C::read(uint8_t address, uint8_t* data, size_t length) {
+    size_t received = receive(address, data, length);
+    bytesRead += received;
+    account(length, received == length);
+    return received;
+}
+
+void ChronoSenseI2C::setClock(uint32_t hz) {
+    this->clockHz = hz > 0 ? hz : CS_I2C_DEFAULT_CLOCK;
+}
+
+void ChronoSenseI2C::resetStats() {
+    transactions = 0;
+    bytesWritten = 0;
+    bytesRead = 0;
+    errors = 0;
+    busMicros = 0;
+}
+
+// Wire backend
+ChronoSenseWireI2C::ChronoSenseWireI2C(TwoWire* wire) {
+    this->wire = wire;
+}
+
+bool ChronoSenseWireI2C::transmit(uint8_t address, const uint8_t* data, size_t length) {
+    wire->beginTransmission(address);
+    if (wire->write(data, length) != length) {
+        wire->endTransmission();
+        return false;
+    }
+    return wire->endTransmission() == 0;
+}
+
+size_t ChronoSenseWireI2C::receive(uint8_t address, uint8_t* data, size_t length) {
+    size_t received = wire->requestFrom(address, (uint8_t)length);
+    for (size_t i = 0; i < received; i++) {
+        data[i] = wire->read();
+    }
+    return received;
+}
+
+size_t ChronoSenseWireI2C::maxWriteLength() {
+    // Wire's transmit buffer: 128 bytes on ESP32, 32 on AVR
+    #if defined(I2C_BUFFER_LENGTH)
+    return I2C_BUFFER_LENGTH;
+    #elif defined(BUFFER_LENGTH)
+    return BUFFER_LENGTH;
+    #else
+    return 32;
+    #endif
+}
+
+void ChronoSenseWireI2C::setClock(uint32_t hz) {
+    ChronoSenseI2C::setClock(hz);
+    wire->setClock(hz);
+}
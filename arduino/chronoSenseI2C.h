@@ -0,0 +1,82 @@
+/*
+ * chronoSenseI2C.h
+ *
+ * I2C transaction layer for ChronoSense sensor and display drivers
+ *
+ * - ChronoSenseI2C: write/read transactions with bus statistics
+ * - ChronoSenseWireI2C: Arduino TwoWire backend
+ *
+ * Drivers only talk to ChronoSenseI2C, so a host build can swap in a
+ * simulated device and check timing and bus usage without hardware.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#ifndef CHRONOSENSE_I2C_H
+#define CHRONOSENSE_I2C_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define CS_I2C_DEFAULT_CLOCK 100000
+
+// Abstract I2C bus. Every transaction is counted; bus time is estimated
+// from the byte count at the configured clock (9 bits per byte plus the
+// address byte and start/stop).
+class ChronoSenseI2C {
+private:
+    uint32_t clockHz;
+    unsigned long transactions;
+    unsigned long bytesWritten;
+    unsigned long bytesRead;
+    unsigned long errors;
+    unsigned long busMicros;
+
+    void account(size_t length, bool ok);
+
+protected:
+    // Backend transfers. transmit() returns false on NACK or bus error;
+    // receive() returns the number of bytes read.
+    virtual bool transmit(uint8_t address, const uint8_t* data, size_t length) = 0;
+    virtual size_t receive(uint8_t address, uint8_t* data, size_t length) = 0;
+
+public:
+    ChronoSenseI2C();
+    virtual ~ChronoSenseI2C() {}
+
+    bool write(uint8_t address, const uint8_t* data, size_t length);
+    size_t read(uint8_t address, uint8_t* data, size_t length);
+
+    // Largest write the backend accepts in one transaction
+    virtual size_t maxWriteLength() { return 32; }
+
+    virtual void setClock(uint32_t hz);
+    uint32_t getClock() { return clockHz; }
+
+    unsigned long getTransactions() { return transactions; }
+    unsigned long getBytesWritten() { return bytesWritten; }
+    unsigned long getBytesRead() { return bytesRead; }
+    unsigned long getErrors() { return errors; }
+    unsigned long getBusTime() { return busMicros; }  // Estimated, microseconds
+    void resetStats();
+};
+
+// Arduino Wire backend
+class ChronoSenseWireI2C : public ChronoSenseI2C {
+private:
+    TwoWire* wire;
+
+protected:
+    bool transmit(uint8_t address, const uint8_t* data, size_t length);
+    size_t receive(uint8_t address, uint8_t* data, size_t length);
+
+public:
+    ChronoSenseWireI2C(TwoWire* wire = &Wire);
+
+    size_t maxWriteLength();
+    void setClock(uint32_t hz);
+};
+
+#endif // CHRONOSENSE_I2C_H
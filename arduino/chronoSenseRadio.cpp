@@ -0,0 +1,364 @@
+/*
+ * chronoSenseRadio.cpp
+ *
+ * Implementation of ChronoSense packet radio support
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#include "chronoSenseArduino.h"
+
+#ifdef CS_USE_NRF24
+// nRF24L01+ backend
+ChronoSenseRF24Radio::ChronoSenseRF24Radio(uint8_t cePin, uint8_t csnPin, uint8_t rfChannel)
+    : radio(cePin, csnPin) {
+    this->rfChannel = rfChannel;
+}
+
+bool ChronoSenseRF24Radio::begin(int group, bool receiver) {
+    if (!radio.begin()) {
+        return false;
+    }
+
+    // Pipe address "CS<group>" keeps classroom groups apart on one RF channel
+    uint64_t address = 0xC5C5C50000ULL | (uint16_t)group;
+
+    radio.setChannel(rfChannel);
+    radio.setPALevel(RF24_PA_LOW);
+    radio.setDataRate(RF24_1MBPS);
+    radio.setPayloadSize(CS_RADIO_PAYLOAD_SIZE);
+    radio.setAutoAck(true);
+    radio.setRetries(5, 15);  // 1.5 ms between retries, up to 15 retries
+
+    if (receiver) {
+        radio.openReadingPipe(1, address);
+        radio.startListening();
+    } else {
+        radio.openWritingPipe(address);
+        radio.stopListening();
+    }
+    return true;
+}
+
+bool ChronoSenseRF24Radio::write(const uint8_t* payload, uint8_t length) {
+    if (radio.isFifo(true, false)) {
+        // TX FIFO full: see whether anything completed before giving up
+        update();
+        if (radio.isFifo(true, false)) {
+            return false;
+        }
+    }
+
+    // Load the FIFO and let the chip send and retry on its own
+    radio.startFastWrite(payload, length, false);
+    return true;
+}
+
+void ChronoSenseRF24Radio::update() {
+    bool txOk, txFail, rxReady;
+    radio.whatHappened(txOk, txFail, rxReady);
+
+    if (txFail) {
+        // Retries exhausted: the chip halts until the FIFO is cleared.
+        // The receiver sees the gap in sequence numbers.
+        radio.flush_tx();
+        txFailures++;
+    }
+}
+
+bool ChronoSenseRF24Radio::available() {
+    return radio.available();
+}
+
+uint8_t ChronoSenseRF24Radio::read(uint8_t* payload, uint8_t maxLength) {
+    uint8_t length = maxLength < CS_RADIO_PAYLOAD_SIZE ? maxLength : CS_RADIO_PAYLOAD_SIZE;
+    radio.read(payload, length);
+    return length;
+}
+#endif
+
+// Loopback backend
+ChronoSenseLoopbackRadio::ChronoSenseLoopbackRadio() {
+    this->head = 0;
+    this->count = 0;
+    this->dropInterval = 0;
+    this->written = 0;
+}
+
+bool ChronoSenseLoopbackRadio::begin(int /* group */, bool /* receiver */) {
+    return true;
+}
+
+bool ChronoSenseLoopbackRadio::write(const uint8_t* payload, uint8_t length) {
+    if (count == QUEUE_SIZE) {
+        return false;
+    }
+
+    written++;
+    if (dropInterval > 0 && written % dropInterval == 0) {
+        // Accepted by the "hardware" but never acknowledged
+        txFailures++;
+        return true;
+    }
+
+    if (length > CS_RADIO_PAYLOAD_SIZE) {
+        length = CS_RADIO_PAYLOAD_SIZE;
+    }
+    int slot = (head + count) % QUEUE_SIZE;
+    memcpy(queue[slot], payload, length);
+    lengths[slot] = length;
+    count++;
+    return true;
+}
+
+void ChronoSenseLoopbackRadio::update() {
+}
+
+bool ChronoSenseLoopbackRadio::available() {
+    return count > 0;
+}
+
+uint8_t ChronoSenseLoopbackRadio::read(uint8_t* payload, uint8_t maxLength) {
+    if (count == 0) {
+        return 0;
+    }
+
+    uint8_t length = lengths[head] < maxLength ? lengths[head] : maxLength;
+    memcpy(payload, queue[head], length);
+    head = (head + 1) % QUEUE_SIZE;
+    count--;
+    return length;
+}
+
+void ChronoSenseLoopbackRadio::setDropInterval(int every) {
+    this->dropInterval = every;
+}
+
+// Packet format
+static uint8_t varintSize(uint32_t value) {
+    uint8_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+static uint32_t zigzagEncode(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t zigzagDecode(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+ChronoSensePacketWriter::ChronoSensePacketWriter() {
+    this->length = 0;
+    this->sequence = 0;
+}
+
+bool ChronoSensePacketWriter::add(const int32_t values[], const uint8_t decimals[], int count) {
+    if (count <= 0 || count > CS_PACKET_MAX_VALUES) {
+        return false;
+    }
+
+    uint32_t packedDecimals = 0;
+    for (int i = 0; i < count; i++) {
+        uint8_t d = decimals[i] > CS_PACKET_MAX_DECIMALS ? CS_PACKET_MAX_DECIMALS : decimals[i];
+        packedDecimals |= (uint32_t)d << (2 * i);
+    }
+
+    uint8_t needed = 0;
+    for (int i = 0; i < count; i++) {
+        needed += varintSize(zigzagEncode(values[i]));
+    }
+
+    if (length == 0) {
+        buffer[0] = CS_PACKET_MAGIC;
+        buffer[1] = sequence & 0xFF;
+        buffer[2] = sequence >> 8;
+        buffer[3] = count;
+        buffer[4] = 0;
+        buffer[5] = packedDecimals & 0xFF;
+        buffer[6] = (packedDecimals >> 8) & 0xFF;
+        buffer[7] = (packedDecimals >> 16) & 0xFF;
+        length = CS_PACKET_HEADER_SIZE;
+    } else {
+        uint32_t current = buffer[5] | (uint32_t)buffer[6] << 8 | (uint32_t)buffer[7] << 16;
+        if (buffer[3] != count || current != packedDecimals) {
+            return false;
+        }
+    }
+
+    if (length + needed > CS_RADIO_PAYLOAD_SIZE) {
+        return false;
+    }
+
+    for (int i = 0; i < count; i++) {
+        uint32_t v = zigzagEncode(values[i]);
+        while (v >= 0x80) {
+            buffer[length++] = (uint8_t)(v | 0x80);
+            v >>= 7;
+        }
+        buffer[length++] = (uint8_t)v;
+    }
+    buffer[4]++;
+    return true;
+}
+
+void ChronoSensePacketWriter::finish() {
+    sequence++;
+    length = 0;
+}
+
+bool ChronoSensePacketReader::begin(const uint8_t* payload, uint8_t length) {
+    this->buffer = payload;
+    this->length = length;
+    this->position = CS_PACKET_HEADER_SIZE;
+
+    if (length < CS_PACKET_HEADER_SIZE || payload[0] != CS_PACKET_MAGIC ||
+        payload[3] == 0 || payload[3] > CS_PACKET_MAX_VALUES) {
+        this->readingsLeft = 0;
+        return false;
+    }
+    this->readingsLeft = payload[4];
+    return true;
+}
+
+void ChronoSensePacketReader::decimals(uint8_t out[]) {
+    uint32_t packed = buffer[5] | (uint32_t)buffer[6] << 8 | (uint32_t)buffer[7] << 16;
+    for (int i = 0; i < buffer[3]; i++) {
+        out[i] = (packed >> (2 * i)) & 0x03;
+    }
+}
+
+bool ChronoSensePacketReader::next(int32_t values[]) {
+    if (readingsLeft == 0) {
+        return false;
+    }
+
+    for (int i = 0; i < buffer[3]; i++) {
+        uint32_t v = 0;
+        uint8_t shift = 0;
+        while (true) {
+            if (position >= length || shift > 28) {
+                readingsLeft = 0;
+                return false;
+            }
+            uint8_t b = buffer[position++];
+            v |= (uint32_t)(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) break;
+            shift += 7;
+        }
+        values[i] = zigzagDecode(v);
+    }
+
+    readingsLeft--;
+    return true;
+}
+
+// Receiver
+ChronoSenseRadioReceiver::ChronoSenseRadioReceiver(ChronoSenseRadio* radio) {
+    this->radio = radio;
+    this->output = &Serial;
+    this->checksumEnabled = true;
+    this->synced = false;
+    this->lastSequence = 0;
+    this->packetsReceived = 0;
+    this->packetsLost = 0;
+    this->duplicates = 0;
+    this->readingsReceived = 0;
+    this->onReadingCallback = nullptr;
+}
+
+bool ChronoSenseRadioReceiver::begin(int group) {
+    return radio != nullptr && radio->begin(group, true);
+}
+
+int ChronoSenseRadioReceiver::update() {
+    if (radio == nullptr) {
+        return 0;
+    }
+
+    unsigned long before = readingsReceived;
+    uint8_t payload[CS_RADIO_PAYLOAD_SIZE];
+
+    radio->update();
+    while (radio->available()) {
+        uint8_t length = radio->read(payload, sizeof(payload));
+        handlePacket(payload, length);
+    }
+
+    return readingsReceived - before;
+}
+
+void ChronoSenseRadioReceiver::handlePacket(const uint8_t* payload, uint8_t length) {
+    ChronoSensePacketReader reader;
+    if (!reader.begin(payload, length)) {
+        return;
+    }
+
+    uint16_t sequence = reader.sequence();
+    if (synced) {
+        uint16_t gap = sequence - (uint16_t)(lastSequence + 1);
+        if (sequence == lastSequence) {
+            // Ack was lost and the sender retransmitted
+            duplicates++;
+            return;
+        }
+        if (gap < 0x8000) {
+            packetsLost += gap;
+        }
+        // Otherwise the sender restarted; resync without counting loss
+    }
+    synced = true;
+    lastSequence = sequence;
+    packetsReceived++;
+
+    int count = reader.valueCount();
+    uint8_t decimals[CS_PACKET_MAX_VALUES];
+    int32_t values[CS_PACKET_MAX_VALUES];
+    reader.decimals(decimals);
+
+    while (reader.next(values)) {
+        readingsReceived++;
+
+        if (onReadingCallback != nullptr) {
+            onReadingCallback(values, decimals, count);
+        }
+
+        if (output != nullptr) {
+            char line[CS_PACKET_MAX_VALUES * 13 + 4];
+            int pos = 0;
+            for (int i = 0; i < count; i++) {
+                if (i > 0) line[pos++] = ',';
+                pos += ChronoSenseUtils::formatFixed(line + pos, values[i], decimals[i]);
+            }
+            if (checksumEnabled) {
+                line[pos++] = ',';
+                line[pos++] = '0' + ChronoSenseUtils::calculateChecksum(values, decimals, count);
+            }
+            line[pos] = '\0';
+            output->println(line);
+        }
+    }
+}
+
+void ChronoSenseRadioReceiver::setOutput(Print* output) {
+    this->output = output;
+}
+
+void ChronoSenseRadioReceiver::enableChecksum(bool enable) {
+    this->checksumEnabled = enable;
+}
+
+void ChronoSenseRadioReceiver::onReading(void (*callback)(const int32_t values[], const uint8_t decimals[], int count)) {
+    this->onReadingCallback = callback;
+}
+
+float ChronoSenseRadioReceiver::getLossRate() {
+    unsigned long total = packetsReceived + packetsLost;
+    return total == 0 ? 0.0f : (float)packetsLost / total;
+}
@@ -0,0 +1,222 @@
+/*
+ * chronoSenseRadio.h
+ *
+ * Packet radio support for the ChronoSense Arduino library
+ *
+ * - ChronoSenseRadio: 32-byte packet radio abstraction
+ * - ChronoSenseRF24Radio: nRF24L01+ backend (needs the RF24 library)
+ * - ChronoSenseLoopbackRadio: in-memory stand-in for host tests
+ * - ChronoSensePacketWriter/Reader: packed fixed-point reading format
+ * - ChronoSenseRadioReceiver: reassembles readings and reports loss
+ *
+ * Packet layout (little endian):
+ *   [0]     CS_PACKET_MAGIC
+ *   [1..2]  sequence number
+ *   [3]     values per reading (1-10)
+ *   [4]     readings in this packet
+ *   [5..7]  decimal places, 2 bits per value (0-3)
+ *   [8..31] zigzag varint values, reading by reading
+ *
+ * Using the nRF24L01+ backend:
+ *   Install the "RF24" library (TMRh20) and add #include <RF24.h> to the
+ *   sketch, above chronoSenseArduino.h. The include is what makes the IDE
+ *   put the library on the include path of every file in the sketch; the
+ *   backend is then picked up automatically. A #define in the sketch does
+ *   not reach the library's .cpp files, so CS_USE_NRF24 only works as a
+ *   build flag (-DCS_USE_NRF24), for toolchains without __has_include.
+ *
+ * nRF24L01+ wiring (Uno/Nano):
+ *   VCC  -> 3.3V (not 5V; add a 10uF capacitor across VCC and GND)
+ *   GND  -> GND
+ *   CE   -> D9  (CS_NRF24_CE_PIN)
+ *   CSN  -> D10 (CS_NRF24_CSN_PIN)
+ *   SCK  -> D13
+ *   MOSI -> D11
+ *   MISO -> D12
+ *   IRQ  -> not connected
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#ifndef CHRONOSENSE_RADIO_H
+#define CHRONOSENSE_RADIO_H
+
+#include <Arduino.h>
+
+// Build the nRF24L01+ backend whenever the RF24 library is reachable
+#if !defined(CS_USE_NRF24) && defined(__has_include)
+    #if __has_include(<RF24.h>)
+        #define CS_USE_NRF24
+    #endif
+#endif
+
+#ifdef CS_USE_NRF24
+    #include <RF24.h>
+#endif
+
+#define CS_RADIO_PAYLOAD_SIZE 32
+#define CS_PACKET_MAGIC 0xC5
+#define CS_PACKET_HEADER_SIZE 8
+#define CS_PACKET_MAX_VALUES 10
+#define CS_PACKET_MAX_DECIMALS 3
+
+// Default nRF24L01+ wiring and RF channel (Uno/Nano)
+#ifndef CS_NRF24_CE_PIN
+#define CS_NRF24_CE_PIN 9
+#endif
+#ifndef CS_NRF24_CSN_PIN
+#define CS_NRF24_CSN_PIN 10
+#endif
+#ifndef CS_NRF24_RF_CHANNEL
+#define CS_NRF24_RF_CHANNEL 76
+#endif
+
+// Abstract packet radio. Writes queue a payload and return immediately;
+// acknowledgements are collected later by update().
+class ChronoSenseRadio {
+protected:
+    unsigned long txFailures;
+
+public:
+    ChronoSenseRadio() : txFailures(0) {}
+    virtual ~ChronoSenseRadio() {}
+
+    // group selects the pipe address, like a micro:bit radio group
+    virtual bool begin(int group, bool receiver) = 0;
+
+    // Queue a payload without waiting for the ack.
+    // Returns false if the transmit queue is full.
+    virtual bool write(const uint8_t* payload, uint8_t length) = 0;
+
+    // Service the radio: collect acks and retransmit failures
+    virtual void update() = 0;
+
+    virtual bool available() = 0;
+    virtual uint8_t read(uint8_t* payload, uint8_t maxLength) = 0;
+
+    unsigned long getTxFailures() { return txFailures; }
+};
+
+#ifdef CS_USE_NRF24
+// nRF24L01+ using hardware auto-ack and auto-retransmit. Up to three
+// payloads are kept in flight in the TX FIFO.
+class ChronoSenseRF24Radio : public ChronoSenseRadio {
+private:
+    RF24 radio;
+    uint8_t rfChannel;
+
+public:
+    ChronoSenseRF24Radio(uint8_t cePin = CS_NRF24_CE_PIN, uint8_t csnPin = CS_NRF24_CSN_PIN,
+                         uint8_t rfChannel = CS_NRF24_RF_CHANNEL);
+
+    bool begin(int group, bool receiver);
+    bool write(const uint8_t* payload, uint8_t length);
+    void update();
+    bool available();
+    uint8_t read(uint8_t* payload, uint8_t maxLength);
+};
+#endif
+
+// In-memory radio: every payload written can be read back from the same
+// object. Optionally drops every Nth payload to simulate loss.
+class ChronoSenseLoopbackRadio : public ChronoSenseRadio {
+private:
+    static const int QUEUE_SIZE = 8;
+    uint8_t queue[QUEUE_SIZE][CS_RADIO_PAYLOAD_SIZE];
+    uint8_t lengths[QUEUE_SIZE];
+    int head;
+    int count;
+    int dropInterval;
+    unsigned long written;
+
+public:
+    ChronoSenseLoopbackRadio();
+
+    bool begin(int group, bool receiver);
+    bool write(const uint8_t* payload, uint8_t length);
+    void update();
+    bool available();
+    uint8_t read(uint8_t* payload, uint8_t maxLength);
+
+    void setDropInterval(int every);
+    unsigned long getWrittenCount() { return written; }
+};
+
+// Packs fixed-point readings into one radio payload
+class ChronoSensePacketWriter {
+private:
+    uint8_t buffer[CS_RADIO_PAYLOAD_SIZE];
+    uint8_t length;
+    uint16_t sequence;
+
+public:
+    ChronoSensePacketWriter();
+
+    // Append a reading. Returns false if it does not fit in this packet
+    // (or its shape differs from readings already in it).
+    bool add(const int32_t values[], const uint8_t decimals[], int count);
+
+    // Start an empty packet with the next sequence number
+    void finish();
+
+    bool isEmpty() { return length == 0; }
+    uint8_t readingCount() { return length == 0 ? 0 : buffer[4]; }
+    const uint8_t* data() { return buffer; }
+    uint8_t size() { return length; }
+};
+
+// Unpacks readings from a received payload
+class ChronoSensePacketReader {
+private:
+    const uint8_t* buffer;
+    uint8_t length;
+    uint8_t position;
+    uint8_t readingsLeft;
+
+public:
+    bool begin(const uint8_t* payload, uint8_t length);
+    uint16_t sequence() { return buffer[1] | (uint16_t)buffer[2] << 8; }
+    uint8_t valueCount() { return buffer[3]; }
+    void decimals(uint8_t out[]);
+
+    // Next reading's values; returns false when exhausted or malformed
+    bool next(int32_t values[]);
+};
+
+// Receives packed readings and forwards them as ChronoSense CSV lines
+class ChronoSenseRadioReceiver {
+private:
+    ChronoSenseRadio* radio;
+    Print* output;
+    bool checksumEnabled;
+    bool synced;
+    uint16_t lastSequence;
+    unsigned long packetsReceived;
+    unsigned long packetsLost;
+    unsigned long duplicates;
+    unsigned long readingsReceived;
+
+    void (*onReadingCallback)(const int32_t values[], const uint8_t decimals[], int count);
+
+    void handlePacket(const uint8_t* payload, uint8_t length);
+
+public:
+    ChronoSenseRadioReceiver(ChronoSenseRadio* radio);
+
+    bool begin(int group);
+    int update();  // Returns readings decoded this call
+
+    void setOutput(Print* output);  // nullptr disables CSV output
+    void enableChecksum(bool enable = true);
+    void onReading(void (*callback)(const int32_t values[], const uint8_t decimals[], int count));
+
+    unsigned long getPacketsReceived() { return packetsReceived; }
+    unsigned long getPacketsLost() { return packetsLost; }
+    unsigned long getDuplicates() { return duplicates; }
+    unsigned long getReadingsReceived() { return readingsReceived; }
+    float getLossRate();
+};
+
+#endif // CHRONOSENSE_RADIO_H
@@ -0,0 +1,472 @@
+/*
+ * chronoSenseSCD4x.cpp
+ *
+ * Implementation of the ChronoSense SCD40/SCD41 driver
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#include "chronoSenseSCD4x.h"
+#include "chronoSenseArduino.h"
+
+#ifdef ESP32
+    #include <esp_sleep.h>
+#endif
+
+// SCD4x commands
+#define SCD4X_START_PERIODIC 0x21B1
+#define SCD4X_START_LOW_POWER 0x21AC
+#define SCD4X_READ_MEASUREMENT 0xEC05
+#define SCD4X_STOP_PERIODIC 0x3F86
+#define SCD4X_DATA_READY 0xE4B8
+#define SCD4X_SINGLE_SHOT 0x219D
+#define SCD4X_POWER_DOWN 0x36E0
+#define SCD4X_WAKE_UP 0x36F6
+#define SCD4X_SERIAL_NUMBER 0x3682
+
+ChronoSenseSCD4x::ChronoSenseSCD4x(ChronoSenseI2C* bus) {
+    this->bus = bus;
+    this->chronoSense = nullptr;
+    this->mode = CS_SCD4X_PERIODIC;
+    this->state = STATE_STOPPED;
+    this->interval = CS_SCD4X_PERIODIC_INTERVAL;
+    this->expectedReady = 0;
+    this->nextAction = 0;
+    this->phaseStep = 0;
+    this->shotStarted = 0;
+    this->retrying = false;
+    this->powerDownEnabled = true;
+    this->lightSleepEnabled = false;
+    this->serialValid = false;
+    this->onReadingCallback = nullptr;
+    memset(&reading, 0, sizeof(reading));
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool ChronoSenseSCD4x::begin(ChronoSenseSCD4xMode mode, unsigned long interval) {
+    this->mode = mode;
+
+    // An SCD41 may still be powered down from before a reset. Wake-up is
+    // never acknowledged, and the SCD40 ignores it.
+    sendCommand(SCD4X_WAKE_UP);
+    delay(CS_SCD4X_WAKE_TIME);
+
+    sendCommand(SCD4X_STOP_PERIODIC);
+    delay(CS_SCD4X_STOP_TIME);
+
+    // Serial number can only be read while idle
+    serialValid = readWords(SCD4X_SERIAL_NUMBER, serialNumber, 3);
+
+    unsigned long now = millis();
+    retrying = false;
+
+    switch (mode) {
+        case CS_SCD4X_PERIODIC:
+        case CS_SCD4X_LOW_POWER:
+            if (!sendCommand(mode == CS_SCD4X_PERIODIC ? SCD4X_START_PERIODIC : SCD4X_START_LOW_POWER)) {
+                state = STATE_STOPPED;
+                return false;
+            }
+            this->interval = mode == CS_SCD4X_PERIODIC ? CS_SCD4X_PERIODIC_INTERVAL : CS_SCD4X_LOW_POWER_INTERVAL;
+            state = STATE_PERIODIC;
+            phaseStep = this->interval / CS_SCD4X_PHASE_DIVISOR;
+            expectedReady = now + this->interval;
+            nextAction = expectedReady;
+            break;
+
+        case CS_SCD4X_SINGLE_SHOT: {
+            // Each shot takes 5 s plus the wake-up
+            unsigned long minimum = CS_SCD4X_SINGLE_SHOT_TIME + CS_SCD4X_WAKE_TIME + CS_SCD4X_POLL_INTERVAL;
+            this->interval = interval > minimum ? interval : minimum;
+            state = STATE_SHOT_WAKING;  // Already awake: start the first shot now
+            nextAction = now;
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool ChronoSenseSCD4x::stop() {
+    bool ok = true;
+    if (state == STATE_PERIODIC) {
+        ok = sendCommand(SCD4X_STOP_PERIODIC);
+        delay(CS_SCD4X_STOP_TIME);
+    }
+    state = STATE_STOPPED;
+    return ok;
+}
+
+bool ChronoSenseSCD4x::update() {
+    if (state == STATE_STOPPED) {
+        return false;
+    }
+
+    unsigned long now = millis();
+    if ((long)(now - nextAction) < 0) {
+        return false;
+    }
+
+    switch (state) {
+        case STATE_SHOT_IDLE:
+            if (powerDownEnabled) {
+                sendCommand(SCD4X_WAKE_UP);
+                state = STATE_SHOT_WAKING;
+                nextAction = now + CS_SCD4X_WAKE_TIME;
+                return false;
+            }
+            // Fall through - sensor stayed awake, start straight away
+        case STATE_SHOT_WAKING:
+            if (!sendCommand(SCD4X_SINGLE_SHOT)) {
+                stats.errors++;
+                state = STATE_SHOT_IDLE;
+                nextAction = now + CS_SCD4X_POLL_INTERVAL;
+                return false;
+            }
+            shotStarted = now;
+            expectedReady = now + CS_SCD4X_SINGLE_SHOT_TIME;
+            nextAction = expectedReady;
+            state = STATE_SHOT_BUSY;
+            return false;
+
+        default:
+            break;
+    }
+
+    // Periodic or single shot in progress: is the measurement there yet?
+    bool ready = false;
+    if (!readDataReady(ready)) {
+        stats.errors++;
+        nextAction = now + CS_SCD4X_POLL_INTERVAL;
+        return false;
+    }
+
+    if (!ready) {
+        stats.notReadyPolls++;
+        retrying = true;
+        nextAction = now + CS_SCD4X_POLL_INTERVAL;
+        return false;
+    }
+
+    if (!readMeasurement()) {
+        stats.errors++;
+        nextAction = now + CS_SCD4X_POLL_INTERVAL;
+        return false;
+    }
+
+    reading.timestamp = now;
+    stats.readings++;
+    stats.lastLatency = retrying ? CS_SCD4X_POLL_INTERVAL : now - expectedReady;
+    scheduleNext(now);
+    deliver();
+    return true;
+}
+
+void ChronoSenseSCD4x::scheduleNext(unsigned long now) {
+    if (state == STATE_PERIODIC) {
+        unsigned long late = now - expectedReady;
+        if (late >= interval) {
+            // The loop stalled and the sensor overwrote unread data
+            stats.missedCycles += late / interval;
+        }
+
+        if (retrying) {
+            // Data appeared within the last poll gap: re-anchor on it
+            expectedReady = now + interval;
+            phaseStep = interval / CS_SCD4X_PHASE_DIVISOR;
+        } else {
+            // Ready on the first try, possibly much earlier than expected.
+            // Creep earlier, faster each time, until a poll finds no data:
+            // a fixed step would fall behind a fast sensor clock, and its
+            // measurements would be overwritten before being read.
+            expectedReady += interval * (1 + late / interval) - phaseStep;
+            phaseStep = phaseStep * 2 < interval / CS_SCD4X_MAX_PHASE_DIVISOR ?
+                        phaseStep * 2 : interval / CS_SCD4X_MAX_PHASE_DIVISOR;
+        }
+        nextAction = expectedReady;
+    } else {
+        if (powerDownEnabled) {
+            sendCommand(SCD4X_POWER_DOWN);
+        }
+        state = STATE_SHOT_IDLE;
+
+        // Next shot starts one interval after this one did
+        nextAction = shotStarted + interval - (powerDownEnabled ? CS_SCD4X_WAKE_TIME : 0);
+        if ((long)(nextAction - now) < 0) {
+            nextAction = now;
+        }
+    }
+    retrying = false;
+}
+
+void ChronoSenseSCD4x::deliver() {
+    if (onReadingCallback != nullptr) {
+        onReadingCallback(reading);
+    }
+    if (chronoSense != nullptr) {
+        chronoSense->sendCO2Data(reading.co2, reading.temperature, reading.humidity, 2);
+    }
+}
+
+unsigned long ChronoSenseSCD4x::timeUntilNextAction() {
+    if (state == STATE_STOPPED) {
+        return 0;
+    }
+    long remaining = (long)(nextAction - millis());
+    return remaining > 0 ? remaining : 0;
+}
+
+unsigned long ChronoSenseSCD4x::sleepUntilNextAction() {
+    unsigned long gap = timeUntilNextAction();
+    if (!lightSleepEnabled || gap < CS_SCD4X_MIN_SLEEP) {
+        return 0;
+    }
+
+    #ifdef ESP32
+    Serial.flush();  // UART output is lost in light sleep
+    esp_sleep_enable_timer_wakeup((uint64_t)gap * 1000ULL);
+    esp_light_sleep_start();
+    return gap;
+    #else
+    return 0;
+    #endif
+}
+
+void ChronoSenseSCD4x::enableLightSleep(bool enable) {
+    this->lightSleepEnabled = enable;
+}
+
+void ChronoSenseSCD4x::enablePowerDown(bool enable) {
+    this->powerDownEnabled = enable;
+}
+
+void ChronoSenseSCD4x::attach(ChronoSense* cs) {
+    this->chronoSense = cs;
+}
+
+void ChronoSenseSCD4x::onReading(void (*callback)(const ChronoSenseSCD4xReading& reading)) {
+    this->onReadingCallback = callback;
+}
+
+bool ChronoSenseSCD4x::getSerialNumber(uint16_t serial[3]) {
+    if (serialValid) {
+        memcpy(serial, serialNumber, sizeof(serialNumber));
+    }
+    return serialValid;
+}
+
+// Bus transactions
+bool ChronoSenseSCD4x::sendCommand(uint16_t command) {
+    uint8_t data[] = {(uint8_t)(command >> 8), (uint8_t)(command & 0xFF)};
+    return bus->write(CS_SCD4X_ADDRESS, data, 2);
+}
+
+bool ChronoSenseSCD4x::readWords(uint16_t command, uint16_t words[], int count) {
+    uint8_t data[9];
+    if (count > 3 || !sendCommand(command)) {
+        return false;
+    }
+
+    delay(CS_SCD4X_COMMAND_TIME);
+    if (bus->read(CS_SCD4X_ADDRESS, data, count * 3) != (size_t)(count * 3)) {
+        return false;
+    }
+
+    // Each word is followed by its CRC
+    for (int i = 0; i < count; i++) {
+        if (crc8(data + i * 3, 2) != data[i * 3 + 2]) {
+            return false;
+        }
+        words[i] = (uint16_t)data[i * 3] << 8 | data[i * 3 + 1];
+    }
+    return true;
+}
+
+bool ChronoSenseSCD4x::readDataReady(bool& ready) {
+    uint16_t status;
+    if (!readWords(SCD4X_DATA_READY, &status, 1)) {
+        return false;
+    }
+    ready = (status & 0x07FF) != 0;
+    return true;
+}
+
+bool ChronoSenseSCD4x::readMeasurement() {
+    uint16_t words[3];
+    if (!readWords(SCD4X_READ_MEASUREMENT, words, 3)) {
+        return false;
+    }
+    reading.co2 = words[0];
+    reading.temperature = toTemperature(words[1]);
+    reading.humidity = toHumidity(words[2]);
+    return true;
+}
+
+uint8_t ChronoSenseSCD4x::crc8(const uint8_t* data, int length) {
+    // Sensirion CRC-8: polynomial 0x31, init 0xFF
+    uint8_t crc = 0xFF;
+    for (int i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+int32_t ChronoSenseSCD4x::toTemperature(uint16_t raw) {
+    // T = -45 + 175 * raw / 65535, rounded to 0.01 degC
+    return -4500 + (int32_t)(((uint32_t)raw * 17500UL + 32767UL) / 65535UL);
+}
+
+int32_t ChronoSenseSCD4x::toHumidity(uint16_t raw) {
+    // RH = 100 * raw / 65535, rounded to 0.01 %
+    return (int32_t)(((uint32_t)raw * 10000UL + 32767UL) / 65535UL);
+}
+
+// Simulated sensor
+ChronoSenseSCD4xSimulator::ChronoSenseSCD4xSimulator() {
+    this->simState = SIM_IDLE;
+    this->period = CS_SCD4X_PERIODIC_INTERVAL;
+    this->cycleStart = 0;
+    this->driftPpm = 0;
+    this->dataReady = false;
+    this->lastCommand = 0;
+    this->co2 = 600;
+    this->rawTemperature = 0x6667;  // 25.0 degC
+    this->rawHumidity = 0x8000;     // 50.0 %RH
+    this->measurements = 0;
+}
+
+void ChronoSenseSCD4xSimulator::setMeasurement(uint16_t co2, uint16_t rawTemperature, uint16_t rawHumidity) {
+    this->co2 = co2;
+    this->rawTemperature = rawTemperature;
+    this->rawHumidity = rawHumidity;
+}
+
+void ChronoSenseSCD4xSimulator::setDrift(long ppm) {
+    this->driftPpm = ppm;
+}
+
+unsigned long ChronoSenseSCD4xSimulator::sensorTime(unsigned long since) {
+    return since + (long)((long long)since * driftPpm / 1000000LL);
+}
+
+void ChronoSenseSCD4xSimulator::advance() {
+    unsigned long elapsed = sensorTime(millis() - cycleStart);
+
+    if (simState == SIM_PERIODIC) {
+        unsigned long completed = elapsed / period;
+        if (completed > measurements) {
+            measurements = completed;
+            dataReady = true;
+        }
+    } else if (simState == SIM_SHOT && elapsed >= CS_SCD4X_SINGLE_SHOT_TIME) {
+        measurements++;
+        dataReady = true;
+        simState = SIM_IDLE;
+    }
+}
+
+void ChronoSenseSCD4xSimulator::putWord(uint8_t* out, uint16_t value) {
+    out[0] = value >> 8;
+    out[1] = value & 0xFF;
+    out[2] = ChronoSenseSCD4x::crc8(out, 2);
+}
+
+bool ChronoSenseSCD4xSimulator::transmit(uint8_t address, const uint8_t* data, size_t length) {
+    if (address != CS_SCD4X_ADDRESS || length != 2) {
+        return false;
+    }
+
+    uint16_t command = (uint16_t)data[0] << 8 | data[1];
+    advance();
+    lastCommand = 0;
+
+    if (simState == SIM_POWERED_DOWN) {
+        // Wakes up, but never acknowledges
+        if (command == SCD4X_WAKE_UP) {
+            simState = SIM_IDLE;
+        }
+        return false;
+    }
+
+    switch (command) {
+        case SCD4X_START_PERIODIC:
+        case SCD4X_START_LOW_POWER:
+            period = command == SCD4X_START_PERIODIC ? CS_SCD4X_PERIODIC_INTERVAL : CS_SCD4X_LOW_POWER_INTERVAL;
+            simState = SIM_PERIODIC;
+            cycleStart = millis();
+            measurements = 0;
+            dataReady = false;
+            return true;
+
+        case SCD4X_STOP_PERIODIC:
+            simState = SIM_IDLE;
+            return true;
+
+        case SCD4X_SINGLE_SHOT:
+            if (simState != SIM_IDLE) {
+                return false;
+            }
+            simState = SIM_SHOT;
+            cycleStart = millis();
+            measurements = 0;
+            return true;
+
+        case SCD4X_POWER_DOWN:
+            if (simState != SIM_IDLE) {
+                return false;
+            }
+            simState = SIM_POWERED_DOWN;
+            dataReady = false;
+            return true;
+
+        case SCD4X_DATA_READY:
+        case SCD4X_READ_MEASUREMENT:
+        case SCD4X_SERIAL_NUMBER:
+            lastCommand = command;
+            return true;
+
+        default:
+            // Includes wake-up while already awake
+            return false;
+    }
+}
+
+size_t ChronoSenseSCD4xSimulator::receive(uint8_t address, uint8_t* data, size_t length) {
+    if (address != CS_SCD4X_ADDRESS) {
+        return 0;
+    }
+
+    advance();
+    uint16_t command = lastCommand;
+    lastCommand = 0;
+
+    switch (command) {
+        case SCD4X_DATA_READY:
+            if (length < 3) return 0;
+            putWord(data, dataReady ? 0x8006 : 0x8000);
+            return 3;
+
+        case SCD4X_READ_MEASUREMENT:
+            if (length < 9 || !dataReady) return 0;
+            putWord(data, co2);
+            putWord(data + 3, rawTemperature);
+            putWord(data + 6, rawHumidity);
+            dataReady = false;
+            return 9;
+
+        case SCD4X_SERIAL_NUMBER:
+            if (length < 9) return 0;
+            putWord(data, 0xC5C5);
+            putWord(data + 3, 0x0001);
+            putWord(data + 6, 0x0040);
+            return 9;
+
+        default:
+            return 0;
+    }
+}
@@ -0,0 +1,188 @@
+/*
+ * chronoSenseSCD4x.h
+ *
+ * Event-driven Sensirion SCD40/SCD41 driver for ChronoSense
+ *
+ * - ChronoSenseSCD4x: non-blocking driver that polls the sensor only when
+ *   a measurement is due, locked to the sensor's own measurement cycle
+ * - ChronoSenseSCD4xSimulator: simulated sensor on a ChronoSenseI2C bus
+ *   for host tests
+ *
+ * Modes:
+ *   CS_SCD4X_PERIODIC     one reading every 5 s (SCD40/41)
+ *   CS_SCD4X_LOW_POWER    one reading every 30 s (SCD40/41)
+ *   CS_SCD4X_SINGLE_SHOT  on demand at a chosen interval, sensor powered
+ *                         down between readings (SCD41 only)
+ *
+ * Readings are integers: CO2 in ppm, temperature and humidity in
+ * hundredths, so they go straight into ChronoSense's fixed-point path.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#ifndef CHRONOSENSE_SCD4X_H
+#define CHRONOSENSE_SCD4X_H
+
+#include <Arduino.h>
+#include "chronoSenseI2C.h"
+
+class ChronoSense;
+
+#define CS_SCD4X_ADDRESS 0x62
+
+// Measurement cycles and command execution times (datasheet, ms)
+#define CS_SCD4X_PERIODIC_INTERVAL 5000
+#define CS_SCD4X_LOW_POWER_INTERVAL 30000
+#define CS_SCD4X_SINGLE_SHOT_TIME 5000
+#define CS_SCD4X_STOP_TIME 500
+#define CS_SCD4X_WAKE_TIME 30
+#define CS_SCD4X_COMMAND_TIME 1
+
+// Retry spacing when data is not ready yet. Each on-time read pulls the
+// schedule earlier, starting at interval / CS_SCD4X_PHASE_DIVISOR and
+// doubling on every further on-time read up to interval /
+// CS_SCD4X_MAX_PHASE_DIVISOR, until a poll comes too early and the
+// schedule re-anchors on the sensor. A sensor clock up to 5% fast is
+// followed without its measurements being overwritten unread.
+#define CS_SCD4X_POLL_INTERVAL 50
+#define CS_SCD4X_PHASE_DIVISOR 200
+#define CS_SCD4X_MAX_PHASE_DIVISOR 20
+
+// Light sleep is only worth it for gaps longer than this (ms)
+#define CS_SCD4X_MIN_SLEEP 20
+
+enum ChronoSenseSCD4xMode {
+    CS_SCD4X_PERIODIC,
+    CS_SCD4X_LOW_POWER,
+    CS_SCD4X_SINGLE_SHOT
+};
+
+struct ChronoSenseSCD4xReading {
+    uint16_t co2;             // ppm
+    int32_t temperature;      // 0.01 degC
+    int32_t humidity;         // 0.01 %RH
+    unsigned long timestamp;  // millis() when read
+};
+
+struct ChronoSenseSCD4xStats {
+    unsigned long readings;
+    unsigned long notReadyPolls;  // Data-ready checks that came back empty
+    unsigned long missedCycles;   // Measurements overwritten before being read
+    unsigned long errors;         // NACKs and CRC failures
+    unsigned long lastLatency;    // ms between expected data ready and read
+};
+
+class ChronoSenseSCD4x {
+private:
+    enum State {
+        STATE_STOPPED,
+        STATE_PERIODIC,     // Sensor measuring on its own cycle
+        STATE_SHOT_IDLE,    // Waiting to start the next single shot
+        STATE_SHOT_WAKING,  // Wake-up sent, sensor starting
+        STATE_SHOT_BUSY     // Single shot in progress
+    };
+
+    ChronoSenseI2C* bus;
+    ChronoSense* chronoSense;
+    ChronoSenseSCD4xMode mode;
+    State state;
+    unsigned long interval;
+    unsigned long expectedReady;  // When the next measurement should be ready
+    unsigned long nextAction;     // When update() next touches the bus
+    unsigned long phaseStep;      // How much earlier the next on-time read moves
+    unsigned long shotStarted;
+    bool retrying;
+    bool powerDownEnabled;
+    bool lightSleepEnabled;
+    bool serialValid;
+    uint16_t serialNumber[3];
+    ChronoSenseSCD4xReading reading;
+    ChronoSenseSCD4xStats stats;
+
+    void (*onReadingCallback)(const ChronoSenseSCD4xReading& reading);
+
+    bool sendCommand(uint16_t command);
+    bool readWords(uint16_t command, uint16_t words[], int count);
+    bool readDataReady(bool& ready);
+    bool readMeasurement();
+    void deliver();
+    void scheduleNext(unsigned long now);
+
+public:
+    ChronoSenseSCD4x(ChronoSenseI2C* bus);
+
+    // Stops any running measurement (500 ms), reads the serial number and
+    // starts the given mode. interval only applies to single-shot mode.
+    bool begin(ChronoSenseSCD4xMode mode = CS_SCD4X_PERIODIC,
+               unsigned long interval = CS_SCD4X_PERIODIC_INTERVAL);
+    bool stop();
+
+    // Call from loop(). Touches the bus only when a reading is due;
+    // returns true when a new reading was taken.
+    bool update();
+
+    // Time until update() next needs to run, for sleeping in between
+    unsigned long timeUntilNextAction();
+
+    // Light-sleep the ESP32 until the next reading is due. WiFi and
+    // Bluetooth links drop in light sleep, so this suits USB and radio
+    // nodes. Returns the time slept (0 if disabled or too short).
+    unsigned long sleepUntilNextAction();
+    void enableLightSleep(bool enable = true);
+
+    // Power the SCD41 down between single shots (default on)
+    void enablePowerDown(bool enable = true);
+
+    // Forward every reading to ChronoSense as "CO2" data
+    void attach(ChronoSense* cs);
+    void onReading(void (*callback)(const ChronoSenseSCD4xReading& reading));
+
+    bool getSerialNumber(uint16_t serial[3]);  // As read by begin()
+    const ChronoSenseSCD4xReading& getReading() { return reading; }
+    ChronoSenseSCD4xStats getStats() { return stats; }
+    unsigned long getInterval() { return interval; }
+    bool isRunning() { return state != STATE_STOPPED; }
+
+    static uint8_t crc8(const uint8_t* data, int length);
+    static int32_t toTemperature(uint16_t raw);  // 0.01 degC
+    static int32_t toHumidity(uint16_t raw);     // 0.01 %RH
+};
+
+// Simulated SCD4x. Follows the command set and timing of the real sensor
+// (data appears one cycle after start, CRC on every word) and runs on a
+// slightly different clock than millis() when drift is set.
+class ChronoSenseSCD4xSimulator : public ChronoSenseI2C {
+private:
+    enum SimState { SIM_IDLE, SIM_PERIODIC, SIM_SHOT, SIM_POWERED_DOWN };
+
+    SimState simState;
+    unsigned long period;
+    unsigned long cycleStart;
+    long driftPpm;
+    bool dataReady;
+    uint16_t lastCommand;
+    uint16_t co2;
+    uint16_t rawTemperature;
+    uint16_t rawHumidity;
+    unsigned long measurements;
+
+    unsigned long sensorTime(unsigned long since);
+    void advance();
+    void putWord(uint8_t* out, uint16_t value);
+
+protected:
+    bool transmit(uint8_t address, const uint8_t* data, size_t length);
+    size_t receive(uint8_t address, uint8_t* data, size_t length);
+
+public:
+    ChronoSenseSCD4xSimulator();
+
+    void setMeasurement(uint16_t co2, uint16_t rawTemperature, uint16_t rawHumidity);
+    void setDrift(long ppm);  // Positive: sensor clock runs fast
+    unsigned long getMeasurements() { return measurements; }
+    bool isPoweredDown() { return simState == SIM_POWERED_DOWN; }
+};
+
+#endif // CHRONOSENSE_SCD4X_H
@@ -0,0 +1,119 @@
+/*
+ * benchFixedPoint.cpp
+ *
+ * Host benchmark for the fixed-point send pipeline: the cost of one
+ * CO2/temperature/humidity reading on the float (dtostrf) path against
+ * the float -> fixed and integer-only paths. Host numbers only show
+ * relative cost; on an FPU-less AVR the float path is far slower still.
+ *
+ *   make bench
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#include "chronoSenseArduino.h"
+#include <chrono>
+
+static const int READINGS = 2000000;
+static const uint8_t DECIMALS[3] = {0, 1, 1};
+
+static volatile size_t sink;
+
+// CSV line as the library built it before the fixed-point pipeline
+static size_t floatLine(char* buffer, float values[], int count) {
+    size_t length = 0;
+    for (int i = 0; i < count; i++) {
+        if (i > 0) buffer[length++] = ',';
+        dtostrf(values[i], 1, DECIMALS[i], buffer + length);
+        length += strlen(buffer + length);
+    }
+    buffer[length++] = ',';
+    buffer[length++] = '0' + ChronoSenseUtils::calculateChecksum(values, count);
+    buffer[length] = '\0';
+    return length;
+}
+
+static size_t fixedLine(char* buffer, const int32_t values[], int count) {
+    size_t length = 0;
+    for (int i = 0; i < count; i++) {
+        if (i > 0) buffer[length++] = ',';
+        length += ChronoSenseUtils::formatFixed(buffer + length, values[i], DECIMALS[i]);
+    }
+    buffer[length++] = ',';
+    buffer[length++] = '0' + ChronoSenseUtils::calculateChecksum(values, DECIMALS, count);
+    buffer[length] = '\0';
+    return length;
+}
+
+static void makeReading(int i, float values[]) {
+    values[0] = 400 + (i & 1023);
+    values[1] = 18.0f + (i & 63) * 0.1f;
+    values[2] = 40.0f + (i & 31) * 0.1f;
+}
+
+template <class Body> static double nanosPerReading(Body body) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < READINGS; i++) {
+        body(i);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / READINGS;
+}
+
+int main() {
+    char buffer[128];
+    float floats[3];
+    int32_t fixed[3];
+
+    double floatPath = nanosPerReading([&](int i) {
+        makeReading(i, floats);
+        sink = sink + floatLine(buffer, floats, 3);
+    });
+
+    double convertPath = nanosPerReading([&](int i) {
+        makeReading(i, floats);
+        for (int k = 0; k < 3; k++) {
+            ChronoSenseUtils::toFixed(floats[k], DECIMALS[k], fixed[k]);
+        }
+        sink = sink + fixedLine(buffer, fixed, 3);
+    });
+
+    double integerPath = nanosPerReading([&](int i) {
+        fixed[0] = 400 + (i & 1023);
+        fixed[1] = 180 + (i & 63);
+        fixed[2] = 400 + (i & 31);
+        sink = sink + fixedLine(buffer, fixed, 3);
+    });
+
+    printf("Formatting one reading (%d readings):\n", READINGS);
+    printf("  float + dtostrf:           %7.1f ns\n", floatPath);
+    printf("  float -> fixed, integer:   %7.1f ns\n", convertPath);
+    printf("  integer input:             %7.1f ns\n", integerPath);
+
+    // The whole send path, out of a USB-serial ChronoSense
+    ChronoSense cs(CS_USB_SERIAL);
+    cs.begin("bench");
+    cs.setChannelPrecision(0, 0);
+
+    double sendFloat = nanosPerReading([&](int i) {
+        makeReading(i, floats);
+        cs.sendSensorData("CO2", floats, 3);
+        Serial.output.clear();
+    });
+
+    // Same reading at one decimal; CO2 is rescaled to the channel's none
+    double sendFixed = nanosPerReading([&](int i) {
+        fixed[0] = (400 + (i & 1023)) * 10;
+        fixed[1] = 180 + (i & 63);
+        fixed[2] = 400 + (i & 31);
+        cs.sendFixedPoint("CO2", fixed, 3, 1);
+        Serial.output.clear();
+    });
+
+    printf("Sending one reading:\n");
+    printf("  sendSensorData(float[]):   %7.1f ns\n", sendFloat);
+    printf("  sendFixedPoint(int32_t[]): %7.1f ns\n", sendFixed);
+    return 0;
+}
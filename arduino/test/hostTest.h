@@ -0,0 +1,33 @@
+/*
+ * hostTest.h
+ *
+ * Minimal checks for the ChronoSense host tests. A failed CHECK prints
+ * the condition and exits non-zero, so make stops at the first failure.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#ifndef CHRONOSENSE_HOST_TEST_H
+#define CHRONOSENSE_HOST_TEST_H
+
+#include <Arduino.h>
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            exit(1); \
+        } \
+    } while (0)
+
+#define CHECK_TEXT(actual, expected) \
+    do { \
+        if (strcmp((actual), (expected)) != 0) { \
+            printf("%s:%d: expected \"%s\", got \"%s\"\n", __FILE__, __LINE__, (expected), (actual)); \
+            exit(1); \
+        } \
+    } while (0)
+
+#endif // CHRONOSENSE_HOST_TEST_H
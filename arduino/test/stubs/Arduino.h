@@ -0,0 +1,229 @@
+/*
+ * Arduino.h (host test stub)
+ *
+ * Just enough of the Arduino core to build the ChronoSense library with a
+ * desktop compiler. millis() runs on a clock the tests advance by hand,
+ * and Serial keeps everything written to it.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#ifndef CHRONOSENSE_TEST_ARDUINO_H
+#define CHRONOSENSE_TEST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+using std::isinf;
+using std::isnan;
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define DEC 10
+#define HEX 16
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+char* dtostrf(double value, signed char width, unsigned char precision, char* buffer);
+
+// Host clock: starts at 1 ms and only moves when a test (or delay()) moves it
+void hostSetMillis(unsigned long ms);
+void hostAdvance(unsigned long ms);
+
+// Text on the heap, grown with realloc to exactly the length needed, as
+// the Arduino cores' WString does. Every String is at least one malloc,
+// so CS_TRACK_HEAP sees String use the way it would on a board.
+class String {
+public:
+    String() { assign("", 0); }
+    String(const char* value) { assign(value != nullptr ? value : "", value != nullptr ? strlen(value) : 0); }
+    String(const String& other) { assign(other.buffer, other.size); }
+    String(String&& other) : buffer(other.buffer), size(other.size), capacity(other.capacity) {
+        other.buffer = nullptr;
+        other.size = other.capacity = 0;
+    }
+    String(char value) { assign(&value, 1); }
+    String(int value, unsigned char base = DEC) { assignNumber(value, base); }
+    String(unsigned int value, unsigned char base = DEC) { assignNumber(value, base); }
+    String(long value, unsigned char base = DEC) { assignNumber(value, base); }
+    String(unsigned long value, unsigned char base = DEC) { assignNumber(value, base); }
+    String(double value, unsigned char decimals = 2) {
+        char text[48];
+        assign(text, snprintf(text, sizeof(text), "%.*f", decimals, value));
+    }
+    ~String() { free(buffer); }
+
+    String& operator=(const String& other) {
+        if (this != &other) {
+            assign(other.buffer, other.size);
+        }
+        return *this;
+    }
+    String& operator=(String&& other) {
+        if (this != &other) {
+            free(buffer);
+            buffer = other.buffer;
+            size = other.size;
+            capacity = other.capacity;
+            other.buffer = nullptr;
+            other.size = other.capacity = 0;
+        }
+        return *this;
+    }
+
+    unsigned int length() const { return size; }
+    const char* c_str() const { return buffer; }
+    void reserve(unsigned int length) {
+        if (buffer == nullptr || length > capacity) {
+            grow(length);
+        }
+    }
+    int toInt() const { return atoi(buffer); }
+    char operator[](unsigned int index) const { return index < size ? buffer[index] : '\0'; }
+
+    String& operator+=(const String& other) {
+        if (&other == this) {
+            String copy(other);  // realloc may move our own text
+            return append(copy.buffer, copy.size);
+        }
+        return append(other.buffer, other.size);
+    }
+    String& operator+=(const char* other) { return append(other, strlen(other)); }
+    String& operator+=(char other) { return append(&other, 1); }
+    bool operator==(const String& other) const { return size == other.size && memcmp(buffer, other.buffer, size) == 0; }
+    bool operator==(const char* other) const { return strcmp(buffer, other) == 0; }
+
+private:
+    char* buffer = nullptr;
+    unsigned int size = 0;
+    unsigned int capacity = 0;
+
+    void grow(unsigned int length) {
+        char* grown = (char*)realloc(buffer, length + 1);
+        if (grown == nullptr) {
+            abort();
+        }
+        buffer = grown;
+        capacity = length;
+    }
+
+    void assign(const char* text, size_t length) {
+        reserve(length);
+        memmove(buffer, text, length);
+        buffer[length] = '\0';
+        size = length;
+    }
+
+    String& append(const char* text, size_t length) {
+        reserve(size + length);
+        memcpy(buffer + size, text, length);
+        size += length;
+        buffer[size] = '\0';
+        return *this;
+    }
+
+    template <class T> void assignNumber(T value, unsigned char base) {
+        char text[24];
+        if (base == HEX) {
+            assign(text, snprintf(text, sizeof(text), "%lx", (unsigned long)value));
+        } else {
+            assign(text, snprintf(text, sizeof(text), "%lld", (long long)value));
+        }
+    }
+};
+
+inline String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+inline String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+
+// Fixed-size record of bytes written to a stub port (never allocates)
+struct HostCapture {
+    char data[16384];
+    size_t length;
+    unsigned long writes;  // write(buffer, size) calls
+
+    HostCapture() { clear(); }
+    void clear() { length = 0; writes = 0; data[0] = '\0'; }
+    void append(const uint8_t* bytes, size_t size) {
+        for (size_t i = 0; i < size && length + 1 < sizeof(data); i++) {
+            data[length++] = bytes[i];
+        }
+        data[length] = '\0';
+    }
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            write(buffer[i]);
+        }
+        return size;
+    }
+    size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+    size_t write(const char* text) { return write(text, strlen(text)); }
+
+    size_t print(const char* text) { return write(text); }
+    size_t print(const String& text) { return write(text.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value, int base = DEC) { return print(String(value, base)); }
+    size_t print(unsigned int value, int base = DEC) { return print(String(value, base)); }
+    size_t print(long value, int base = DEC) { return print(String(value, base)); }
+    size_t print(unsigned long value, int base = DEC) { return print(String(value, base)); }
+    size_t print(double value, int decimals = 2) { return print(String(value, decimals)); }
+
+    size_t println() { return write("\r\n"); }
+    template <class T> size_t println(const T& value) { return print(value) + println(); }
+    template <class T> size_t println(const T& value, int format) { return print(value, format) + println(); }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int peek() { return -1; }
+    virtual void flush() {}
+};
+
+class HardwareSerial : public Stream {
+public:
+    HostCapture output;
+
+    void begin(unsigned long) {}
+    operator bool() const { return true; }
+
+    using Print::write;
+    size_t write(uint8_t c) { output.append(&c, 1); return 1; }
+    size_t write(const uint8_t* buffer, size_t size) {
+        output.writes++;
+        output.append(buffer, size);
+        return size;
+    }
+};
+
+extern HardwareSerial Serial;
+
+#ifdef ESP32
+class EspClass {
+public:
+    uint32_t getFreeHeap() { return 200000; }
+    uint32_t getMinFreeHeap() { return 180000; }
+};
+
+extern EspClass ESP;
+#endif
+
+#endif // CHRONOSENSE_TEST_ARDUINO_H
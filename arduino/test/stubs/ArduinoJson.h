@@ -0,0 +1,201 @@
+/*
+ * ArduinoJson.h (host test stub)
+ *
+ * The small part of the ArduinoJson 6 API the library uses: flat objects
+ * of strings and integers, one nested array of strings, and
+ * serializeJson(). Like StaticJsonDocument it never allocates, and like
+ * ArduinoJson it keeps const char* values by pointer.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#ifndef CHRONOSENSE_TEST_ARDUINO_JSON_H
+#define CHRONOSENSE_TEST_ARDUINO_JSON_H
+
+#include <Arduino.h>
+
+#define JSON_ARRAY_SIZE(n) ((n) * 16)
+#define JSON_OBJECT_SIZE(n) ((n) * 16)
+
+class JsonDocument;
+
+class JsonArray {
+public:
+    JsonArray(JsonDocument* document, int member) : document(document), member(member) {}
+    bool add(const char* value);
+
+private:
+    JsonDocument* document;
+    int member;
+};
+
+class JsonVariant {
+public:
+    JsonVariant(JsonDocument* document, int member) : document(document), member(member) {}
+    JsonVariant& operator=(const char* value);
+    JsonVariant& operator=(long long value);
+
+private:
+    JsonDocument* document;
+    int member;
+};
+
+class JsonDocument {
+public:
+    static const int MAX_MEMBERS = 8;
+    static const int MAX_ITEMS = 64;
+
+    JsonDocument() : memberCount(0), itemCount(0) {}
+
+    JsonVariant operator[](const char* key) { return JsonVariant(this, find(key)); }
+    JsonArray createNestedArray(const char* key) {
+        int member = find(key);
+        if (member >= 0) {
+            members[member].kind = Member::ARRAY;
+            members[member].first = itemCount;
+            members[member].count = 0;
+        }
+        return JsonArray(this, member);
+    }
+
+    size_t serialize(char* output, size_t capacity) const {
+        size_t length = 0;
+        put(output, capacity, length, "{");
+        for (int m = 0; m < memberCount; m++) {
+            const Member& member = members[m];
+            if (member.kind == Member::NONE) {
+                continue;
+            }
+            if (length > 1) {
+                put(output, capacity, length, ",");
+            }
+            putString(output, capacity, length, member.key);
+            put(output, capacity, length, ":");
+            if (member.kind == Member::STRING) {
+                putString(output, capacity, length, member.text);
+            } else if (member.kind == Member::INTEGER) {
+                char number[24];
+                snprintf(number, sizeof(number), "%lld", member.number);
+                put(output, capacity, length, number);
+            } else {
+                put(output, capacity, length, "[");
+                for (int i = 0; i < member.count; i++) {
+                    if (i > 0) {
+                        put(output, capacity, length, ",");
+                    }
+                    putString(output, capacity, length, items[member.first + i]);
+                }
+                put(output, capacity, length, "]");
+            }
+        }
+        put(output, capacity, length, "}");
+        if (capacity > 0) {
+            output[length < capacity ? length : capacity - 1] = '\0';
+        }
+        return length;  // Full length, even if output was too small
+    }
+
+private:
+    friend class JsonArray;
+    friend class JsonVariant;
+
+    struct Member {
+        enum Kind { NONE, STRING, INTEGER, ARRAY } kind;
+        const char* key;
+        const char* text;
+        long long number;
+        int first;
+        int count;
+    };
+
+    Member members[MAX_MEMBERS];
+    int memberCount;
+    const char* items[MAX_ITEMS];
+    int itemCount;
+
+    int find(const char* key) {
+        for (int m = 0; m < memberCount; m++) {
+            if (strcmp(members[m].key, key) == 0) {
+                return m;
+            }
+        }
+        if (memberCount == MAX_MEMBERS) {
+            return -1;
+        }
+        members[memberCount].kind = Member::NONE;
+        members[memberCount].key = key;
+        return memberCount++;
+    }
+
+    static void put(char* output, size_t capacity, size_t& length, const char* text) {
+        while (*text != '\0') {
+            if (length + 1 < capacity) {
+                output[length] = *text;
+            }
+            length++;
+            text++;
+        }
+    }
+
+    static void putString(char* output, size_t capacity, size_t& length, const char* text) {
+        put(output, capacity, length, "\"");
+        for (; *text != '\0'; text++) {
+            char escaped[3] = {'\\', *text, '\0'};
+            put(output, capacity, length, (*text == '"' || *text == '\\') ? escaped : escaped + 1);
+        }
+        put(output, capacity, length, "\"");
+    }
+};
+
+inline bool JsonArray::add(const char* value) {
+    if (member < 0 || document->itemCount == JsonDocument::MAX_ITEMS) {
+        return false;
+    }
+    document->items[document->itemCount++] = value;
+    document->members[member].count++;
+    return true;
+}
+
+inline JsonVariant& JsonVariant::operator=(const char* value) {
+    if (member >= 0) {
+        document->members[member].kind = JsonDocument::Member::STRING;
+        document->members[member].text = value;
+    }
+    return *this;
+}
+
+inline JsonVariant& JsonVariant::operator=(long long value) {
+    if (member >= 0) {
+        document->members[member].kind = JsonDocument::Member::INTEGER;
+        document->members[member].number = value;
+    }
+    return *this;
+}
+
+template <size_t capacity> class StaticJsonDocument : public JsonDocument {};
+
+class DynamicJsonDocument : public JsonDocument {
+public:
+    explicit DynamicJsonDocument(size_t) {}
+};
+
+inline size_t measureJson(const JsonDocument& document) {
+    return document.serialize(nullptr, 0);
+}
+
+inline size_t serializeJson(const JsonDocument& document, char* output, size_t capacity) {
+    // Like ArduinoJson: output is truncated to fit and always terminated
+    size_t length = document.serialize(output, capacity);
+    return length < capacity ? length : capacity - 1;
+}
+
+inline size_t serializeJson(const JsonDocument& document, String& output) {
+    char buffer[512];
+    size_t length = document.serialize(buffer, sizeof(buffer));
+    output = buffer;
+    return length;
+}
+
+#endif // CHRONOSENSE_TEST_ARDUINO_JSON_H
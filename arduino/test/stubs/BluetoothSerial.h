@@ -0,0 +1,30 @@
+/*
+ * BluetoothSerial.h (host test stub)
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#ifndef CHRONOSENSE_TEST_BLUETOOTH_SERIAL_H
+#define CHRONOSENSE_TEST_BLUETOOTH_SERIAL_H
+
+#include <Arduino.h>
+
+class BluetoothSerial : public Stream {
+public:
+    HostCapture output;
+
+    bool begin(const char*) { return true; }
+    bool connected(int = 0) { return true; }
+
+    using Print::write;
+    size_t write(uint8_t c) { output.append(&c, 1); return 1; }
+    size_t write(const uint8_t* buffer, size_t size) {
+        output.writes++;
+        output.append(buffer, size);
+        return size;
+    }
+};
+
+#endif // CHRONOSENSE_TEST_BLUETOOTH_SERIAL_H
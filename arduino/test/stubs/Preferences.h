@@ -0,0 +1,90 @@
+/*
+ * Preferences.h (host test stub)
+ *
+ * In-memory NVS: values survive a new ChronoSense object (a reboot) until
+ * a test calls Preferences::erase() (flash wiped). Counts flash writes.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#ifndef CHRONOSENSE_TEST_PREFERENCES_H
+#define CHRONOSENSE_TEST_PREFERENCES_H
+
+#include <Arduino.h>
+
+#define RTC_DATA_ATTR
+
+class Preferences {
+public:
+    static const int MAX_KEYS = 4;
+    static const size_t MAX_VALUE = 128;
+
+    static unsigned long writes;
+
+    bool begin(const char*, bool readOnly = false) { this->readOnly = readOnly; return true; }
+    void end() {}
+
+    size_t getBytes(const char* key, void* buffer, size_t length) {
+        Entry* entry = find(key, false);
+        if (entry == nullptr || entry->length > length) {
+            return 0;
+        }
+        memcpy(buffer, entry->value, entry->length);
+        return entry->length;
+    }
+
+    size_t putBytes(const char* key, const void* value, size_t length) {
+        Entry* entry = readOnly || length > MAX_VALUE ? nullptr : find(key, true);
+        if (entry == nullptr) {
+            return 0;
+        }
+        memcpy(entry->value, value, length);
+        entry->length = length;
+        writes++;
+        return length;
+    }
+
+    bool remove(const char* key) {
+        Entry* entry = find(key, false);
+        if (entry != nullptr) {
+            entry->key[0] = '\0';
+        }
+        return entry != nullptr;
+    }
+
+    static void erase() {
+        for (int i = 0; i < MAX_KEYS; i++) {
+            store[i].key[0] = '\0';
+        }
+        writes = 0;
+    }
+
+private:
+    struct Entry {
+        char key[16];
+        uint8_t value[MAX_VALUE];
+        size_t length;
+    };
+
+    static Entry store[MAX_KEYS];
+    bool readOnly = false;
+
+    static Entry* find(const char* key, bool create) {
+        for (int i = 0; i < MAX_KEYS; i++) {
+            if (strcmp(store[i].key, key) == 0) {
+                return &store[i];
+            }
+        }
+        for (int i = 0; create && i < MAX_KEYS; i++) {
+            if (store[i].key[0] == '\0') {
+                snprintf(store[i].key, sizeof(store[i].key), "%s", key);
+                return &store[i];
+            }
+        }
+        return nullptr;
+    }
+};
+
+#endif // CHRONOSENSE_TEST_PREFERENCES_H
@@ -0,0 +1,43 @@
+/*
+ * RF24.h (host test stub)
+ *
+ * Lets ChronoSenseRF24Radio compile on the host. No chip is attached:
+ * begin() fails, so tests use ChronoSenseLoopbackRadio instead.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#ifndef CHRONOSENSE_TEST_RF24_H
+#define CHRONOSENSE_TEST_RF24_H
+
+#include <Arduino.h>
+
+typedef enum { RF24_PA_MIN, RF24_PA_LOW, RF24_PA_HIGH, RF24_PA_MAX } rf24_pa_dbm_e;
+typedef enum { RF24_1MBPS, RF24_2MBPS, RF24_250KBPS } rf24_datarate_e;
+
+class RF24 {
+public:
+    RF24(uint16_t, uint16_t) {}
+
+    bool begin() { return false; }
+    void setChannel(uint8_t) {}
+    void setPALevel(uint8_t, bool = true) {}
+    bool setDataRate(rf24_datarate_e) { return true; }
+    void setPayloadSize(uint8_t) {}
+    void setAutoAck(bool) {}
+    void setRetries(uint8_t, uint8_t) {}
+    void openReadingPipe(uint8_t, uint64_t) {}
+    void openWritingPipe(uint64_t) {}
+    void startListening() {}
+    void stopListening() {}
+    bool isFifo(bool, bool) { return false; }
+    void startFastWrite(const void*, uint8_t, const bool, bool = true) {}
+    void whatHappened(bool& txOk, bool& txFail, bool& rxReady) { txOk = txFail = rxReady = false; }
+    uint8_t flush_tx() { return 0; }
+    bool available() { return false; }
+    void read(void*, uint8_t) {}
+};
+
+#endif // CHRONOSENSE_TEST_RF24_H
@@ -0,0 +1,75 @@
+/*
+ * WebSocketsClient.h (host test stub)
+ *
+ * Records the server the library asked for and every text frame sent.
+ * Tests drive the connection by firing events at the last client.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#ifndef CHRONOSENSE_TEST_WEBSOCKETS_CLIENT_H
+#define CHRONOSENSE_TEST_WEBSOCKETS_CLIENT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+typedef enum {
+    WStype_ERROR,
+    WStype_DISCONNECTED,
+    WStype_CONNECTED,
+    WStype_TEXT,
+    WStype_BIN
+} WStype_t;
+
+class WebSocketsClient {
+public:
+    typedef void (*WebSocketClientEvent)(WStype_t type, uint8_t* payload, size_t length);
+
+    static WebSocketsClient* last;  // Most recently configured client
+    static HostCapture output;      // Text frames, one per line
+
+    char host[64];
+    uint16_t port;
+
+    WebSocketsClient() : port(0), event(nullptr) { host[0] = '\0'; }
+    ~WebSocketsClient() {
+        if (last == this) {
+            last = nullptr;
+        }
+    }
+
+    void begin(const char* host, uint16_t port, const char* = "/") {
+        snprintf(this->host, sizeof(this->host), "%s", host);
+        this->port = port;
+        last = this;
+    }
+    void begin(IPAddress host, uint16_t port, const char* url = "/") {
+        begin(host.toString().c_str(), port, url);
+    }
+    void onEvent(WebSocketClientEvent callback) { event = callback; }
+    void setReconnectInterval(unsigned long) {}
+    void loop() {}
+
+    bool sendTXT(const uint8_t* payload, size_t length) {
+        output.writes++;
+        output.append(payload, length);
+        output.append((const uint8_t*)"\n", 1);
+        return true;
+    }
+    bool sendTXT(const char* payload) { return sendTXT((const uint8_t*)payload, strlen(payload)); }
+    bool sendTXT(String& payload) { return sendTXT(payload.c_str()); }
+
+    // Test side: deliver an event as the real client's loop() would
+    void fire(WStype_t type, const char* text = "") {
+        if (event != nullptr) {
+            event(type, (uint8_t*)text, strlen(text));
+        }
+    }
+
+private:
+    WebSocketClientEvent event;
+};
+
+#endif // CHRONOSENSE_TEST_WEBSOCKETS_CLIENT_H
@@ -0,0 +1,134 @@
+/*
+ * WiFi.h (host test stub)
+ *
+ * ESP32 WiFi and WiFiClient with knobs for the tests: link state, DNS
+ * and TCP failures, plus counters of what the library asked for.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#ifndef CHRONOSENSE_TEST_WIFI_H
+#define CHRONOSENSE_TEST_WIFI_H
+
+#include <Arduino.h>
+
+#define WL_IDLE_STATUS 0
+#define WL_NO_SSID_AVAIL 1
+#define WL_CONNECTED 3
+#define WL_CONNECT_FAILED 4
+#define WL_DISCONNECTED 6
+
+#define WIFI_STA 1
+
+typedef int wl_status_t;
+
+class IPAddress {
+public:
+    uint32_t value;
+
+    IPAddress() : value(0) {}
+    IPAddress(uint32_t value) : value(value) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : value(a | (uint32_t)b << 8 | (uint32_t)c << 16 | (uint32_t)d << 24) {}
+
+    operator uint32_t() const { return value; }
+    String toString() const {
+        char text[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", (unsigned)(value & 0xFF), (unsigned)(value >> 8 & 0xFF),
+                 (unsigned)(value >> 16 & 0xFF), (unsigned)(value >> 24));
+        return String(text);
+    }
+};
+
+class WiFiClient : public Stream {
+public:
+    static bool acceptConnections;    // false: connect() fails
+    static unsigned long connects;    // connect() calls
+    static IPAddress lastAddress;
+    static HostCapture output;        // Bytes written by any client
+
+    WiFiClient() : open(false) {}
+
+    int connect(IPAddress address, uint16_t) {
+        connects++;
+        lastAddress = address;
+        open = acceptConnections;
+        return open ? 1 : 0;
+    }
+    uint8_t connected() { return open; }
+    void stop() { open = false; }
+    void setNoDelay(bool) {}
+
+    using Print::write;
+    size_t write(uint8_t c) { output.append(&c, 1); return 1; }
+    size_t write(const uint8_t* buffer, size_t size) {
+        output.writes++;
+        output.append(buffer, size);
+        return size;
+    }
+
+private:
+    bool open;
+};
+
+class WiFiClass {
+public:
+    wl_status_t linkStatus;  // What status() reports
+    bool dnsWorks;           // false: hostByName() fails
+    IPAddress serverAddress; // What hostByName() resolves to
+    unsigned long begins;
+    unsigned long configs;
+    unsigned long lookups;
+    int32_t lastChannel;     // Channel passed to the last begin()
+
+    WiFiClass() { reset(); }
+    void reset() {
+        linkStatus = WL_CONNECTED;
+        dnsWorks = true;
+        serverAddress = IPAddress(192, 168, 1, 10);
+        begins = 0;
+        configs = 0;
+        lookups = 0;
+        lastChannel = 0;
+    }
+
+    wl_status_t status() { return linkStatus; }
+    int begin(const char*, const char*, int32_t channel = 0, const uint8_t* = nullptr, bool = true) {
+        begins++;
+        lastChannel = channel;
+        return linkStatus;
+    }
+    bool config(IPAddress, IPAddress, IPAddress, IPAddress = IPAddress(), IPAddress = IPAddress()) {
+        configs++;
+        return true;
+    }
+    bool disconnect(bool = false, bool = false) { return true; }
+    bool mode(int) { return true; }
+    bool persistent(bool) { return true; }
+    bool setHostname(const char*) { return true; }
+    bool setSleep(bool) { return true; }
+    bool setAutoReconnect(bool) { return true; }
+
+    IPAddress localIP() { return IPAddress(192, 168, 1, 50); }
+    IPAddress gatewayIP() { return IPAddress(192, 168, 1, 1); }
+    IPAddress subnetMask() { return IPAddress(255, 255, 255, 0); }
+    IPAddress dnsIP(uint8_t = 0) { return IPAddress(192, 168, 1, 1); }
+    uint8_t* BSSID() { static uint8_t bssid[6] = {0x24, 0x0A, 0xC4, 0x01, 0x02, 0x03}; return bssid; }
+    int32_t channel() { return 6; }
+    int32_t RSSI() { return -55; }
+
+    int hostByName(const char*, IPAddress& result) {
+        lookups++;
+        if (!dnsWorks) {
+            return 0;
+        }
+        result = serverAddress;
+        return 1;
+    }
+};
+
+extern WiFiClass WiFi;
+
+#endif // CHRONOSENSE_TEST_WIFI_H
@@ -0,0 +1,33 @@
+/*
+ * Wire.h (host test stub)
+ *
+ * No devices answer; tests use the simulated ChronoSenseI2C buses.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#ifndef CHRONOSENSE_TEST_WIRE_H
+#define CHRONOSENSE_TEST_WIRE_H
+
+#include <Arduino.h>
+
+#define I2C_BUFFER_LENGTH 128
+
+class TwoWire {
+public:
+    bool begin() { return true; }
+    void setClock(uint32_t) {}
+    void beginTransmission(uint8_t) {}
+    size_t write(const uint8_t*, size_t length) { return length; }
+    size_t write(uint8_t) { return 1; }
+    uint8_t endTransmission(bool = true) { return 2; }  // Address NACK
+    size_t requestFrom(uint8_t, uint8_t) { return 0; }
+    int available() { return 0; }
+    int read() { return -1; }
+};
+
+extern TwoWire Wire;
+
+#endif // CHRONOSENSE_TEST_WIRE_H
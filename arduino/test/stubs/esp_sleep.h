@@ -0,0 +1,19 @@
+/*
+ * esp_sleep.h (host test stub)
+ *
+ * Light sleep returns at once; the tests move the clock themselves.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#ifndef CHRONOSENSE_TEST_ESP_SLEEP_H
+#define CHRONOSENSE_TEST_ESP_SLEEP_H
+
+#include <stdint.h>
+
+inline int esp_sleep_enable_timer_wakeup(uint64_t) { return 0; }
+inline int esp_light_sleep_start() { return 0; }
+
+#endif // CHRONOSENSE_TEST_ESP_SLEEP_H
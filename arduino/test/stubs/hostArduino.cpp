@@ -0,0 +1,64 @@
+/*
+ * hostArduino.cpp
+ *
+ * Globals and clock behind the host test stubs
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <WebSocketsClient.h>
+#include <WiFi.h>
+#include <Wire.h>
+
+static unsigned long hostMillis = 1;
+
+unsigned long millis() {
+    return hostMillis;
+}
+
+unsigned long micros() {
+    return hostMillis * 1000UL;
+}
+
+void delay(unsigned long ms) {
+    hostMillis += ms;
+}
+
+void delayMicroseconds(unsigned int) {
+}
+
+void hostSetMillis(unsigned long ms) {
+    hostMillis = ms;
+}
+
+void hostAdvance(unsigned long ms) {
+    hostMillis += ms;
+}
+
+char* dtostrf(double value, signed char width, unsigned char precision, char* buffer) {
+    sprintf(buffer, "%*.*f", width, precision, value);
+    return buffer;
+}
+
+HardwareSerial Serial;
+TwoWire Wire;
+WiFiClass WiFi;
+
+#ifdef ESP32
+EspClass ESP;
+#endif
+
+bool WiFiClient::acceptConnections = true;
+unsigned long WiFiClient::connects = 0;
+IPAddress WiFiClient::lastAddress;
+HostCapture WiFiClient::output;
+
+WebSocketsClient* WebSocketsClient::last = nullptr;
+HostCapture WebSocketsClient::output;
+
+unsigned long Preferences::writes = 0;
+Preferences::Entry Preferences::store[Preferences::MAX_KEYS];
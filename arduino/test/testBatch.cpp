@@ -0,0 +1,181 @@
+/*
+ * testBatch.cpp
+ *
+ * sendBatch(): invalid readings and readings pushed out of a full buffer
+ * are reported in the result bitmap, lines match the single-reading
+ * calls, stream transports get one write per block, and WebSocket/TCP
+ * JSON get one message carrying an array of lines.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#include "hostTest.h"
+#include "chronoSenseArduino.h"
+
+static char sentLines[8][64];
+static int sentCount = 0;
+
+static void onSent(const char* data, size_t length) {
+    if (sentCount < 8) {
+        snprintf(sentLines[sentCount], sizeof(sentLines[0]), "%.*s", (int)length, data);
+    }
+    sentCount++;
+}
+
+// Line sent by the single-reading path, for comparison
+static void singleLine(ChronoSense& cs, char* line, size_t size, int co2, float temperature, float humidity) {
+    sentCount = 0;
+    CHECK(cs.sendCO2Data(co2, temperature, humidity));
+    CHECK(sentCount == 1);
+    snprintf(line, size, "%s", sentLines[0]);
+}
+
+int main() {
+    float co2[] = {800, 60000, 812, NAN, 900, 700};
+    float temperature[] = {21.54f, 20, 22, 20, INFINITY, 19.96f};
+    float humidity[] = {45.26f, 40, 41, 40, 40, 101};
+    ChronoSenseBatch batch = {"CO2", 3, 6, {co2, temperature, humidity}};
+    uint32_t invalid = 1 << 1 | 1 << 3 | 1 << 4 | 1 << 5;
+
+    char first[64], second[64], expected[160];
+
+    {
+        ChronoSense cs(CS_USB_SERIAL);
+        CHECK(cs.begin("batch-usb"));
+        cs.onDataSent(onSent);
+        singleLine(cs, first, sizeof(first), 800, 21.54f, 45.26f);
+        singleLine(cs, second, sizeof(second), 812, 22.0f, 41.0f);
+        CHECK(strncmp(first, "800,21.5,45.3,", 14) == 0);  // CO2 as an integer
+
+        Serial.output.clear();
+        sentCount = 0;
+        CHECK(cs.sendBatch(batch) == invalid);
+        snprintf(expected, sizeof(expected), "%s\r\n%s\r\n", first, second);
+        CHECK_TEXT(Serial.output.data, expected);
+        CHECK(Serial.output.writes == 1);
+        CHECK(sentCount == 2);
+        CHECK_TEXT(sentLines[0], first);
+        CHECK_TEXT(sentLines[1], second);
+
+        // Array of readings: runs of one sensor type go as column batches
+        SensorReading readings[5];
+        readings[0] = SensorReading("Temperature");
+        readings[0].addValue(21.5f);
+        readings[1] = SensorReading("Temperature");
+        readings[1].addValue(200.0f);
+        readings[2] = SensorReading("Distance");
+        readings[2].addValue(12.3f);
+        readings[3] = SensorReading("Distance");
+        readings[4] = SensorReading("Accelerometer");
+        readings[4].addValue(1);
+        readings[4].addValue(-2);
+        readings[4].addValue(3);
+        sentCount = 0;
+        CHECK(cs.sendBatch(readings, 5) == (1 << 1 | 1 << 3));
+        CHECK(sentCount == 3);
+        char accelerometer[64];
+        snprintf(accelerometer, sizeof(accelerometer), "%s", sentLines[2]);
+        sentCount = 0;
+        CHECK(cs.sendAccelerometerData(1, -2, 3));
+        CHECK_TEXT(accelerometer, sentLines[0]);  // Whole numbers, as here
+
+        // Two credits and no buffering: the rest are dropped
+        float x[] = {1, 2, 3, 4};
+        ChronoSenseBatch small = {"X", 1, 4, {x}};
+        cs.enableFlowControl(true);
+        cs.grantCredits(2);
+        CHECK(cs.sendBatch(small) == 0xC);
+        CHECK(cs.getCredits() == 0);
+
+        // With buffering they wait for credits instead
+        cs.enableDataBuffering(true);
+        CHECK(cs.sendBatch(small) == 0);
+        CHECK(cs.getBufferedCount() == 4);
+        cs.enableFlowControl(false);
+        cs.loop();
+
+        // Largest batch still goes out in one block
+        float big[CS_MAX_BATCH];
+        for (int i = 0; i < CS_MAX_BATCH; i++) {
+            big[i] = i * 0.5f;
+        }
+        ChronoSenseBatch full = {"X", 1, CS_MAX_BATCH, {big}};
+        Serial.output.clear();
+        CHECK(cs.sendBatch(full) == 0);
+        CHECK(Serial.output.writes == 1);
+        ChronoSenseBatch tooBig = {"X", 1, CS_MAX_BATCH + 1, {big}};
+        CHECK(cs.sendBatch(tooBig) == 0xFFFFFFFF);
+
+        // More readings than buffer slots: the lines already waiting go
+        // first, then this batch's oldest, which are reported as not sent
+        unsigned long dropped = cs.getDroppedCount();
+        cs.enableFlowControl(true);
+        CHECK(cs.sendBatch(small) == 0);
+        CHECK(cs.sendBatch(full) == (1UL << (CS_MAX_BATCH - CS_BUFFER_SIZE)) - 1);
+        CHECK(cs.getBufferedCount() == CS_BUFFER_SIZE);
+        CHECK(cs.getDroppedCount() == dropped + 4 + CS_MAX_BATCH - CS_BUFFER_SIZE);
+        Serial.output.clear();
+        cs.enableFlowControl(false);
+        cs.loop();
+        snprintf(expected, sizeof(expected), "%.1f,", big[CS_MAX_BATCH - CS_BUFFER_SIZE]);
+        CHECK(strncmp(Serial.output.data, expected, strlen(expected)) == 0);
+    }
+
+    {
+        // TCP JSON: one message, one line per array element
+        ChronoSense cs(CS_WIFI_TCP);
+        cs.setWiFi("classroom", "secret");
+        cs.setServer("chronosense.local", 8080);
+        CHECK(cs.begin("batch-tcp"));
+        cs.onDataSent(onSent);
+
+        WiFiClient::output.clear();
+        sentCount = 0;
+        CHECK(cs.sendBatch(batch) == invalid);
+        snprintf(expected, sizeof(expected), "\"data\":[\"%s\",\"%s\"]", first, second);
+        CHECK(strstr(WiFiClient::output.data, expected) != nullptr);
+        CHECK(strstr(WiFiClient::output.data, "{\"type\":\"sensor_batch\",\"device\":\"batch-tcp\"") ==
+              WiFiClient::output.data);
+        CHECK(strchr(WiFiClient::output.data, '\n') == WiFiClient::output.data + WiFiClient::output.length - 1);
+        CHECK(sentCount == 2);
+        CHECK_TEXT(sentLines[1], second);
+
+        // CSV: the block itself
+        cs.setEncoding(CS_ENCODING_CSV);
+        WiFiClient::output.clear();
+        CHECK(cs.sendBatch(batch) == invalid);
+        snprintf(expected, sizeof(expected), "%s\r\n%s\r\n", first, second);
+        CHECK_TEXT(WiFiClient::output.data, expected);
+        CHECK(WiFiClient::output.writes == 1);
+    }
+
+    {
+        // WebSocket: one frame per batch in either encoding
+        ChronoSense cs(CS_WIFI_WEBSOCKET);
+        cs.setWiFi("classroom", "secret");
+        cs.setServer("chronosense.local", 8080);
+        cs.enableBackgroundConnect();
+        CHECK(cs.begin("batch-ws"));
+        cs.loop();
+        CHECK(WebSocketsClient::last != nullptr);
+        WebSocketsClient::last->fire(WStype_CONNECTED);
+
+        WebSocketsClient::output.clear();
+        CHECK(cs.sendBatch(batch) == invalid);
+        CHECK(WebSocketsClient::output.writes == 1);
+        snprintf(expected, sizeof(expected), "\"data\":[\"%s\",\"%s\"]", first, second);
+        CHECK(strstr(WebSocketsClient::output.data, expected) != nullptr);
+
+        cs.setEncoding(CS_ENCODING_CSV);
+        WebSocketsClient::output.clear();
+        CHECK(cs.sendBatch(batch) == invalid);
+        CHECK(WebSocketsClient::output.writes == 1);
+        snprintf(expected, sizeof(expected), "%s\r\n%s\n", first, second);
+        CHECK_TEXT(WebSocketsClient::output.data, expected);
+    }
+
+    printf("testBatch: pass\n");
+    return 0;
+}
@@ -0,0 +1,211 @@
+/*
+ * testFastConnect.cpp
+ *
+ * WiFi fast connect and server reconnects: the cached BSSID/channel and
+ * server address are used on the next boot, a failed lookup or connect is
+ * retried with backoff, and a server address or AP that stops working is
+ * forgotten in flash as well as in RTC memory. WebSocket drops leave the
+ * cache alone.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#include "hostTest.h"
+#include "chronoSenseArduino.h"
+
+static const char* HOST = "chronosense.local";
+static const int PORT = 8080;
+
+// serverIP is the last field of the cache record kept in flash
+static uint32_t storedServerIP() {
+    uint8_t record[Preferences::MAX_VALUE];
+    Preferences prefs;
+    prefs.begin("chronosense", true);
+    size_t length = prefs.getBytes("net", record, sizeof(record));
+    prefs.end();
+    uint32_t address = 0;
+    if (length >= sizeof(address)) {
+        memcpy(&address, record + length - sizeof(address), sizeof(address));
+    }
+    return address;
+}
+
+static bool hasStoredRecord() {
+    uint8_t record[Preferences::MAX_VALUE];
+    Preferences prefs;
+    prefs.begin("chronosense", true);
+    size_t length = prefs.getBytes("net", record, sizeof(record));
+    prefs.end();
+    return length > 0;
+}
+
+static void configure(ChronoSense& cs) {
+    cs.setWiFi("classroom", "secret");
+    cs.setServer(HOST, PORT);
+}
+
+// Advance the clock and run loop() once
+static void runFor(ChronoSense& cs, unsigned long ms) {
+    hostAdvance(ms);
+    cs.loop();
+}
+
+int main() {
+    IPAddress oldServer(192, 168, 1, 10);
+    IPAddress newServer(192, 168, 1, 20);
+
+    {
+        // First boot: full scan, server looked up and cached
+        ChronoSense cs(CS_WIFI_TCP);
+        configure(cs);
+        CHECK(cs.begin("fast-first"));
+        CHECK(!cs.usedFastConnect());
+        CHECK(WiFi.lastChannel == 0);
+        CHECK(WiFi.lookups == 1);
+        CHECK(storedServerIP() == oldServer);
+    }
+
+    {
+        // Next boot: cached BSSID/channel, static IP and server address
+        WiFi.reset();
+        ChronoSense cs(CS_WIFI_TCP);
+        configure(cs);
+        CHECK(cs.begin("fast-second"));
+        CHECK(cs.usedFastConnect());
+        CHECK(WiFi.lastChannel == 6 && WiFi.configs == 1 && WiFi.begins == 1);
+        CHECK(WiFi.lookups == 0);
+        CHECK(WiFiClient::lastAddress == oldServer);
+    }
+
+    {
+        // The server moved: the cached address fails, is dropped from
+        // flash, and the retry looks the host up again
+        WiFi.reset();
+        WiFi.serverAddress = newServer;
+        WiFiClient::acceptConnections = false;
+        unsigned long writes = Preferences::writes;
+        ChronoSense cs(CS_WIFI_TCP);
+        configure(cs);
+        cs.enableBackgroundConnect();
+        CHECK(cs.begin("fast-moved"));
+        cs.loop();
+        CHECK(!cs.isConnected());
+        CHECK(WiFiClient::lastAddress == oldServer);
+        CHECK(storedServerIP() == 0);
+        CHECK(Preferences::writes == writes + 1);
+
+        WiFiClient::acceptConnections = true;
+        runFor(cs, CS_RECONNECT_MAX_DELAY);
+        CHECK(cs.isConnected());
+        CHECK(WiFi.lookups == 1);
+        CHECK(WiFiClient::lastAddress == newServer);
+        CHECK(storedServerIP() == newServer);
+    }
+
+    {
+        // DNS down: the TCP connect is retried with a doubling delay
+        WiFi.reset();
+        WiFi.dnsWorks = false;
+        ChronoSense cs(CS_WIFI_TCP);
+        cs.clearNetworkCache();
+        configure(cs);
+        cs.enableBackgroundConnect();
+        CHECK(cs.begin("fast-dns"));
+        cs.loop();
+        CHECK(!cs.isConnected());
+        CHECK(WiFi.lookups == 1);
+
+        runFor(cs, CS_RECONNECT_MIN_DELAY);          // 2 s backoff from here
+        CHECK(WiFi.lookups == 2);
+        runFor(cs, CS_RECONNECT_MIN_DELAY);
+        CHECK(WiFi.lookups == 2);
+        runFor(cs, CS_RECONNECT_MIN_DELAY);          // 4 s from here
+        CHECK(WiFi.lookups == 3);
+        for (int i = 0; i < 120; i++) {
+            runFor(cs, 1000);
+        }
+        unsigned long lookups = WiFi.lookups;
+        while (WiFi.lookups == lookups) {
+            runFor(cs, 1000);
+        }
+        runFor(cs, CS_RECONNECT_MAX_DELAY - 1000);  // Delay is capped
+        CHECK(WiFi.lookups == lookups + 1);
+        runFor(cs, 1000);
+        CHECK(WiFi.lookups == lookups + 2);
+
+        WiFi.dnsWorks = true;
+        runFor(cs, CS_RECONNECT_MAX_DELAY);
+        CHECK(cs.isConnected());
+        CHECK(WiFiClient::lastAddress == oldServer);
+    }
+
+    {
+        // WebSocket: connects by host name, so the Host header is right
+        WiFi.reset();
+        ChronoSense cs(CS_WIFI_WEBSOCKET);
+        configure(cs);
+        cs.enableBackgroundConnect();
+        CHECK(cs.begin("fast-ws"));
+        cs.loop();
+        CHECK(WebSocketsClient::last != nullptr);
+        CHECK_TEXT(WebSocketsClient::last->host, HOST);
+        CHECK(WebSocketsClient::last->port == PORT);
+        CHECK(WiFi.lookups == 0);
+
+        // A drop leaves the cached TCP address, and flash, alone
+        CHECK(storedServerIP() == oldServer);
+        WebSocketsClient::last->fire(WStype_CONNECTED);
+        unsigned long writes = Preferences::writes;
+        WebSocketsClient::last->fire(WStype_DISCONNECTED);
+        CHECK(!cs.isConnected());
+        WebSocketsClient::last->fire(WStype_ERROR);
+        CHECK(storedServerIP() == oldServer);
+        CHECK(Preferences::writes == writes);
+    }
+
+    {
+        // WebSocket without a server yet: retried once one is set
+        WiFi.reset();
+        ChronoSense cs(CS_WIFI_WEBSOCKET);
+        cs.setWiFi("classroom", "secret");
+        cs.enableBackgroundConnect();
+        CHECK(cs.begin("fast-ws-late"));
+        cs.loop();
+        CHECK(WebSocketsClient::last == nullptr);
+        cs.setServer(HOST, PORT);
+        runFor(cs, CS_RECONNECT_MAX_DELAY);
+        CHECK(WebSocketsClient::last != nullptr);
+        CHECK_TEXT(WebSocketsClient::last->host, HOST);
+    }
+
+    {
+        // The cached AP is gone: the record is dropped from flash as well,
+        // so the next cold boot scans straight away
+        WiFi.reset();
+        WiFi.linkStatus = WL_DISCONNECTED;
+        CHECK(hasStoredRecord());
+        ChronoSense cs(CS_WIFI_TCP);
+        configure(cs);
+        cs.enableBackgroundConnect();
+        cs.begin("fast-gone");
+        runFor(cs, CS_FAST_CONNECT_TIMEOUT);
+        CHECK(!hasStoredRecord());
+        runFor(cs, CS_SCAN_CONNECT_TIMEOUT);
+        CHECK(!cs.isConnected());
+    }
+
+    {
+        WiFi.reset();
+        ChronoSense cs(CS_WIFI_TCP);
+        configure(cs);
+        CHECK(cs.begin("fast-rescan"));
+        CHECK(!cs.usedFastConnect());
+        CHECK(WiFi.begins == 1);
+        CHECK(hasStoredRecord());
+    }
+
+    printf("testFastConnect: pass\n");
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * testFixedPoint.cpp
+ *
+ * Fixed-point lines at their largest: ten channels at three decimals with
+ * values at the ends of the int32_t range fit every line buffer on the
+ * way out, whether sent, buffered, batched or wrapped in JSON. Fixed-point
+ * input is rescaled to whatever precision the host has chosen.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#include "hostTest.h"
+#include "chronoSenseArduino.h"
+
+static char lastSent[256];
+
+static void onSent(const char* data, size_t length) {
+    snprintf(lastSent, sizeof(lastSent), "%.*s", (int)length, data);
+}
+
+// Ten copies of value, comma separated, ahead of the checksum
+static void repeated(char* line, size_t size, const char* value) {
+    size_t length = 0;
+    for (int i = 0; i < 10; i++) {
+        length += snprintf(line + length, size - length, i > 0 ? ",%s" : "%s", value);
+    }
+}
+
+static bool startsWith(const char* text, const char* prefix) {
+    return strncmp(text, prefix, strlen(prefix)) == 0;
+}
+
+int main() {
+    float pressure[10];
+    int32_t lowest[10];
+    for (int i = 0; i < 10; i++) {
+        pressure[i] = -2147482.0f;
+        lowest[i] = INT32_MIN;
+    }
+
+    char floatLine[160], fixedLine[160];
+    repeated(floatLine, sizeof(floatLine), "-2147481.984");  // Float rounding at 10^3
+    repeated(fixedLine, sizeof(fixedLine), "-2147483.648");
+
+    {
+        ChronoSense cs(CS_USB_SERIAL);
+        CHECK(cs.begin("fixed-usb"));
+        cs.onDataSent(onSent);
+        cs.setPrecision(3);
+
+        CHECK(cs.sendSensorData("Pressure", pressure, 10));
+        CHECK(startsWith(lastSent, floatLine));
+        CHECK(strlen(lastSent) == strlen(floatLine) + 2);
+
+        CHECK(cs.sendFixedPoint("Pressure", lowest, 10, 3));
+        CHECK(startsWith(lastSent, fixedLine));
+        CHECK(strlen(lastSent) == strlen(fixedLine) + 2);
+        CHECK(strlen(lastSent) < CS_MAX_LINE_LENGTH);
+
+        // Held back for credits, then sent whole
+        cs.enableDataBuffering(true);
+        cs.enableFlowControl(true);
+        CHECK(cs.sendFixedPoint("Pressure", lowest, 10, 3));
+        CHECK(cs.getBufferedCount() == 1);
+        lastSent[0] = '\0';
+        cs.grantCredits(1);
+        CHECK(startsWith(lastSent, fixedLine));
+        cs.enableFlowControl(false);
+
+        // The same line in a batch
+        const float* columns[10];
+        for (int i = 0; i < 10; i++) {
+            columns[i] = &pressure[i];
+        }
+        ChronoSenseBatch batch = {"Pressure", 10, 1, {}};
+        memcpy(batch.values, columns, sizeof(columns));
+        CHECK(cs.sendBatch(batch) == 0);
+        CHECK(startsWith(lastSent, floatLine));
+    }
+
+    {
+        // The caller's decimals, not the channel precision, give the scale
+        ChronoSense cs(CS_USB_SERIAL);
+        CHECK(cs.begin("fixed-rescale"));
+        cs.onDataSent(onSent);
+        int32_t climate[] = {2154, 452};
+        CHECK(cs.sendFixedPoint("Climate", climate, 2, 2));
+        CHECK(startsWith(lastSent, "21.5,4.5,") && strlen(lastSent) == 10);
+        cs.setPrecision(0);
+        CHECK(cs.sendFixedPoint("Climate", climate, 2, 2));
+        CHECK(startsWith(lastSent, "22,5,") && strlen(lastSent) == 6);
+        cs.setPrecision(3);
+        CHECK(cs.sendFixedPoint("Climate", climate, 2, 2));
+        CHECK(startsWith(lastSent, "21.540,4.520,") && strlen(lastSent) == 14);
+
+        // Too large once scaled up to the channel precision
+        int32_t large[] = {INT32_MAX / 100};
+        CHECK(!cs.sendFixedPoint("Pressure", large, 1, 0));
+        CHECK(cs.sendFixedPoint("Pressure", large, 1, 3));
+        CHECK(!cs.sendFixedPoint("Pressure", large, 1, 4));
+    }
+
+    {
+        // JSON wraps the longest line in one message
+        ChronoSense cs(CS_WIFI_TCP);
+        cs.setWiFi("classroom", "secret");
+        cs.setServer("chronosense.local", 8080);
+        CHECK(cs.begin("fixed-tcp"));
+        cs.setPrecision(3);
+
+        WiFiClient::output.clear();
+        CHECK(cs.sendFixedPoint("Pressure", lowest, 10, 3));
+        CHECK(strstr(WiFiClient::output.data, fixedLine) != nullptr);
+    }
+
+    printf("testFixedPoint: pass\n");
+    return 0;
+}
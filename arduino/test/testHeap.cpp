@@ -0,0 +1,129 @@
+/*
+ * testHeap.cpp
+ *
+ * Steady-state sending must not touch the heap. Built with CS_TRACK_HEAP
+ * and malloc wrapped at link time, so every malloc, realloc and calloc is
+ * counted: String, like the cores' WString, allocates with them.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#include "hostTest.h"
+#include "chronoSenseArduino.h"
+
+static size_t sentBytes = 0;
+
+static void onSent(const char* data, size_t length) {
+    (void)data;
+    sentBytes += length;
+}
+
+static void onSentString(String data) {
+    sentBytes += data.length();
+}
+
+static void sendEverything(ChronoSense& cs) {
+    float co2[] = {812.0f, 21.54f, 45.2f};
+    int counts[] = {1023, -7};
+    int32_t fixed[] = {2154, 452};
+    float temperatures[] = {20.5f, 20.6f, 20.7f, 20.8f};
+    ChronoSenseBatch batch = {"Temperature", 1, 4, {temperatures}};
+
+    for (int i = 0; i < 20; i++) {
+        cs.sendSensorData("CO2", co2, 3);
+        cs.sendSensorData("Temperature", 20.5f);
+        cs.sendSensorData("ADC", counts, 2);
+        cs.sendFixedPoint("Climate", fixed, 2, 2);
+        cs.sendCO2Data(812, 21.54f, 45.2f);
+        cs.sendCO2Data(812, (int32_t)2154, (int32_t)4520, 2);
+        cs.sendRawCSV("1,2,3");
+        cs.sendBatch(batch);
+        cs.loop();
+    }
+}
+
+static void checkSteadyState(const char* name, ChronoSense& cs) {
+    cs.onDataSent(onSent);
+    sendEverything(cs);  // First use of any lazily created state
+    cs.resetHeapStats();
+    sentBytes = 0;
+
+    sendEverything(cs);
+
+    // Host throttles: most readings wait in the ring buffer, then drain
+    cs.enableDataBuffering(true);
+    cs.handleCommand("CREDIT 5", 8);
+    sendEverything(cs);
+    cs.handleCommand("STATUS", 6);
+    cs.handleCommand("FLOW OFF", 8);
+    cs.loop();
+
+    ChronoSenseHeapStats stats = cs.getHeapStats();
+    printf("%-16s %lu allocations, %lu on the send path, %lu bytes sent\n", name,
+           stats.allocations, stats.hotPathAllocations, (unsigned long)sentBytes);
+    CHECK(sentBytes > 0);
+    CHECK(stats.hotPathAllocations == 0);
+    CHECK(stats.allocations == 0);
+}
+
+int main() {
+    {
+        // C allocations are counted as well as operator new
+        static void* volatile block;
+        unsigned long before = ChronoSenseHeap::allocationCount();
+        block = malloc(16);
+        block = realloc(block, 32);
+        free(block);
+        block = calloc(4, 8);
+        free(block);
+        CHECK(ChronoSenseHeap::allocationCount() == before + 3);
+    }
+
+    {
+        ChronoSense cs(CS_USB_SERIAL);
+        CHECK(cs.begin("heap-usb"));
+        checkSteadyState("USB serial", cs);
+
+        // The String callback allocates per line: the counter must see it
+        cs.onDataSent(onSentString);
+        cs.resetHeapStats();
+        cs.sendSensorData("Temperature", 20.5f);
+        CHECK(cs.getHeapStats().hotPathAllocations > 0);
+    }
+
+    {
+        ChronoSense cs(CS_BLUETOOTH);
+        CHECK(cs.begin("heap-bt"));
+        checkSteadyState("Bluetooth", cs);
+    }
+
+    {
+        ChronoSense cs(CS_WIFI_TCP);
+        cs.setWiFi("classroom", "secret");
+        cs.setServer("chronosense.local", 8080);
+        CHECK(cs.begin("heap-tcp"));
+        checkSteadyState("TCP JSON", cs);
+        cs.setEncoding(CS_ENCODING_CSV);
+        checkSteadyState("TCP CSV", cs);
+    }
+
+    {
+        ChronoSense cs(CS_WIFI_WEBSOCKET);
+        cs.setWiFi("classroom", "secret");
+        cs.setServer("chronosense.local", 8080);
+        cs.enableBackgroundConnect();
+        CHECK(cs.begin("heap-ws"));
+        cs.loop();
+        CHECK(WebSocketsClient::last != nullptr);
+        WebSocketsClient::last->fire(WStype_CONNECTED);
+        CHECK(cs.isConnected());
+        checkSteadyState("WebSocket JSON", cs);
+        cs.setEncoding(CS_ENCODING_CSV);
+        checkSteadyState("WebSocket CSV", cs);
+    }
+
+    printf("testHeap: pass\n");
+    return 0;
+}
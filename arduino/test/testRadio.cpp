@@ -0,0 +1,98 @@
+/*
+ * testRadio.cpp
+ *
+ * Packet radio: readings sent in CS_RADIO_NRF24 mode over the loopback
+ * radio come out of ChronoSenseRadioReceiver as the same CSV lines, lost
+ * packets are counted, and the nRF24L01+ backend is built automatically
+ * when <RF24.h> is reachable (here, the stub in stubs/).
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#include "hostTest.h"
+#include "chronoSenseArduino.h"
+
+// First line of output, and how many lines there were
+static void firstLine(char* line, size_t size, int* count) {
+    const char* text = Serial.output.data;
+    const char* end = strstr(text, "\r\n");
+    snprintf(line, size, "%.*s", end != nullptr ? (int)(end - text) : 0, text);
+    *count = 0;
+    for (; (end = strstr(text, "\r\n")) != nullptr; text = end + 2) {
+        (*count)++;
+    }
+}
+
+static int sendReadings(ChronoSense& cs, ChronoSenseRadioReceiver& receiver, int readings) {
+    int received = 0;
+    for (int i = 0; i < readings; i++) {
+        float values[] = {800.0f + i, 21.5f, 45.2f};
+        CHECK(cs.sendSensorData("CO2", values, 3));
+        received += receiver.update();
+    }
+    return received;
+}
+
+int main() {
+    char line[64];
+    int lines;
+
+    #ifndef CS_USE_NRF24
+    CHECK(!"RF24 backend not detected");
+    #else
+    {
+        // Stub chip never answers
+        ChronoSense cs(CS_RADIO_NRF24);
+        CHECK(!cs.begin("radio-none"));
+    }
+    #endif
+
+    {
+        ChronoSenseLoopbackRadio loopback;
+        ChronoSense cs(CS_RADIO_NRF24);
+        cs.setRadio(&loopback);
+        CHECK(cs.begin("radio-tx"));
+
+        ChronoSenseRadioReceiver receiver(&loopback);
+        CHECK(receiver.begin(144));
+
+        Serial.output.clear();
+        int received = sendReadings(cs, receiver, 40);
+        firstLine(line, sizeof(line), &lines);
+        CHECK(received == lines);
+        CHECK(received >= 36);  // The last packet may still be filling
+        CHECK(strncmp(line, "800.0,21.5,45.2,", 16) == 0);
+        CHECK(receiver.getPacketsLost() == 0);
+        CHECK(receiver.getLossRate() == 0.0f);
+    }
+
+    {
+        // Every third packet lost
+        ChronoSenseLoopbackRadio loopback;
+        loopback.setDropInterval(3);
+        ChronoSense cs(CS_RADIO_NRF24);
+        cs.setRadio(&loopback);
+        CHECK(cs.begin("radio-loss"));
+
+        ChronoSenseRadioReceiver receiver(&loopback);
+        receiver.enableChecksum(false);
+        CHECK(receiver.begin(144));
+
+        Serial.output.clear();
+        int received = sendReadings(cs, receiver, 40);
+        firstLine(line, sizeof(line), &lines);
+        printf("radio: %lu packets written, %lu received, %lu lost, %d readings\n",
+               loopback.getWrittenCount(), receiver.getPacketsReceived(),
+               receiver.getPacketsLost(), received);
+        CHECK(received == lines);
+        CHECK_TEXT(line, "800.0,21.5,45.2");
+        CHECK(receiver.getPacketsLost() > 0);
+        CHECK(receiver.getPacketsReceived() + receiver.getPacketsLost() + 1 >= loopback.getWrittenCount());
+        CHECK(received < 40);
+    }
+
+    printf("testRadio: pass\n");
+    return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * testRawCSV.cpp
+ *
+ * sendRawCSV(data, length): long lines go straight out on transports that
+ * need no copy, unterminated slices are sent with their own length, and
+ * only buffering and JSON messages impose a size limit.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#include "hostTest.h"
+#include "chronoSenseArduino.h"
+
+static char lastSent[512];
+static char lastError[64];
+
+static void onSent(const char* data, size_t length) {
+    snprintf(lastSent, sizeof(lastSent), "%.*s", (int)length, data);
+}
+
+static void onError(const char* error, size_t length) {
+    snprintf(lastError, sizeof(lastError), "%.*s", (int)length, error);
+}
+
+int main() {
+    // 200 digits and commas, followed by bytes that are not part of the line
+    char source[260];
+    for (int i = 0; i < 200; i++) {
+        source[i] = i % 4 == 3 ? ',' : '0' + i % 10;
+    }
+    memset(source + 200, 'X', sizeof(source) - 200);
+    char expected[210];
+    snprintf(expected, sizeof(expected), "%.200s\r\n", source);
+
+    {
+        ChronoSense cs(CS_USB_SERIAL);
+        CHECK(cs.begin("raw-usb"));
+        cs.onDataSent(onSent);
+        cs.onError(onError);
+
+        Serial.output.clear();
+        CHECK(cs.sendRawCSV(source, 200));
+        CHECK_TEXT(Serial.output.data, expected);
+        CHECK(strlen(lastSent) == 200);
+
+        // Out of credits: short lines wait in the buffer, long ones cannot
+        cs.enableDataBuffering(true);
+        cs.enableFlowControl(true);
+        CHECK(cs.sendRawCSV("1,2,3", 5));
+        CHECK(cs.getBufferedCount() == 1);
+        CHECK(!cs.sendRawCSV(source, 200));
+        CHECK_TEXT(lastError, "Line too long to buffer");
+        CHECK(cs.getBufferedCount() == 1);
+
+        Serial.output.clear();
+        cs.grantCredits(2);
+        CHECK_TEXT(Serial.output.data, "1,2,3\r\n");
+        CHECK(cs.sendRawCSV(source, 200));
+        CHECK(strlen(Serial.output.data) == 7 + 202);
+    }
+
+    {
+        ChronoSense cs(CS_WIFI_TCP);
+        cs.setWiFi("classroom", "secret");
+        cs.setServer("chronosense.local", 8080);
+        CHECK(cs.begin("raw-tcp"));
+        cs.onError(onError);
+        cs.setEncoding(CS_ENCODING_CSV);
+
+        WiFiClient::output.clear();
+        CHECK(cs.sendRawCSV(source, 200));
+        CHECK_TEXT(WiFiClient::output.data, expected);
+
+        // A JSON envelope has to fit one CS_MAX_MESSAGE_LENGTH message
+        cs.setEncoding(CS_ENCODING_JSON);
+        WiFiClient::output.clear();
+        CHECK(cs.sendRawCSV(source, 120));
+        CHECK(strstr(WiFiClient::output.data, "\"data\":\"012,456,890,234,") != nullptr);
+        CHECK(strstr(WiFiClient::output.data, "X") == nullptr);
+        CHECK(!cs.sendRawCSV(source, 200));
+        CHECK_TEXT(lastError, "Line too long for a JSON message");
+    }
+
+    printf("testRawCSV: pass\n");
+    return 0;
+}
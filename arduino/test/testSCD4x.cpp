@@ -0,0 +1,133 @@
+/*
+ * testSCD4x.cpp
+ *
+ * SCD4x driver against the simulated sensor: readings follow the sensor's
+ * own clock when it runs fast or slow, every measurement is either read
+ * or counted as missed, single shots power the sensor down in between,
+ * and readings reach ChronoSense as integer CO2 lines.
+ *
+ * Author: St. Mary's Edenderry
+ * Version: 1.0
+ * Date: November 2025
+ */
+
+#include "hostTest.h"
+#include "chronoSenseArduino.h"
+#include "chronoSenseSCD4x.h"
+
+static const unsigned long MINUTE = 60000UL;
+static const unsigned long HOUR = 60 * MINUTE;
+
+static char lastLine[64];
+
+static void onSent(const char* data, size_t length) {
+    snprintf(lastLine, sizeof(lastLine), "%.*s", (int)length, data);
+}
+
+// Run update() whenever the driver asks to, as a sleeping loop would
+static void runFor(ChronoSenseSCD4x& scd, unsigned long duration, unsigned long* maxLatency) {
+    unsigned long start = millis();
+    while (millis() - start < duration) {
+        if (scd.update() && scd.getStats().lastLatency > *maxLatency) {
+            *maxLatency = scd.getStats().lastLatency;
+        }
+        unsigned long gap = scd.timeUntilNextAction();
+        hostAdvance(gap > 0 ? gap : 1);
+    }
+}
+
+static void checkTracking(long driftPpm, ChronoSenseSCD4xMode mode, unsigned long duration) {
+    ChronoSenseSCD4xSimulator sensor;
+    sensor.setDrift(driftPpm);
+    ChronoSenseSCD4x scd(&sensor);
+    CHECK(scd.begin(mode));
+    sensor.resetStats();
+
+    unsigned long maxLatency = 0;
+    runFor(scd, duration, &maxLatency);
+
+    ChronoSenseSCD4xStats stats = scd.getStats();
+    unsigned long cycles = duration / scd.getInterval();
+    printf("drift %+6ld ppm, %2lu s cycle: %4lu readings, %4lu measurements, %lu missed, "
+           "%3lu not ready, %3lu ms max latency, %lu us on the bus\n",
+           driftPpm, scd.getInterval() / 1000, stats.readings, sensor.getMeasurements(),
+           stats.missedCycles, stats.notReadyPolls, maxLatency, sensor.getBusTime());
+
+    CHECK(stats.errors == 0);
+    CHECK(stats.missedCycles == 0);
+    // Every measurement read, bar one the sensor may just have made
+    CHECK(stats.readings + stats.missedCycles + 1 >= sensor.getMeasurements());
+    CHECK(maxLatency <= CS_SCD4X_POLL_INTERVAL + CS_SCD4X_COMMAND_TIME);
+    // Early polls per cycle: about one, plus one per poll interval that
+    // a slow sensor clock falls behind each cycle
+    long lag = driftPpm < 0 ? -driftPpm * (long)scd.getInterval() / 1000000L : 0;
+    CHECK(stats.notReadyPolls <= cycles * (1 + lag / CS_SCD4X_POLL_INTERVAL));
+}
+
+int main() {
+    CHECK(ChronoSenseSCD4x::crc8((const uint8_t*)"\xBE\xEF", 2) == 0x92);
+    CHECK(ChronoSenseSCD4x::toTemperature(0x6667) == 2500);
+    CHECK(ChronoSenseSCD4x::toTemperature(0) == -4500);
+    CHECK(ChronoSenseSCD4x::toHumidity(0x8000) == 5000);
+
+    const long drifts[] = {0, 4000, -4000, 8000, -8000, 20000, -20000, 45000};
+    for (size_t i = 0; i < sizeof(drifts) / sizeof(drifts[0]); i++) {
+        checkTracking(drifts[i], CS_SCD4X_PERIODIC, HOUR);
+    }
+    checkTracking(8000, CS_SCD4X_LOW_POWER, HOUR);
+    checkTracking(-8000, CS_SCD4X_LOW_POWER, HOUR);
+
+    {
+        // Single shot every minute, powered down in between
+        ChronoSenseSCD4xSimulator sensor;
+        ChronoSenseSCD4x scd(&sensor);
+        CHECK(scd.begin(CS_SCD4X_SINGLE_SHOT, MINUTE));
+        unsigned long start = millis();
+        unsigned long poweredDown = 0;
+        int readings = 0;
+        while (millis() - start < 10 * MINUTE) {
+            if (scd.update()) {
+                readings++;
+            }
+            if (sensor.isPoweredDown()) {
+                poweredDown++;
+            }
+            unsigned long gap = scd.timeUntilNextAction();
+            hostAdvance(gap > 0 ? gap : 1);
+        }
+        CHECK(readings == 10);
+        CHECK(poweredDown > 0);
+        CHECK(scd.getStats().errors == 0);
+    }
+
+    {
+        // Readings reach ChronoSense as integer CO2 lines
+        ChronoSenseSCD4xSimulator sensor;
+        sensor.setMeasurement(812, 0x6667, 0x8000);
+        ChronoSenseSCD4x scd(&sensor);
+        ChronoSense cs(CS_USB_SERIAL);
+        CHECK(cs.begin("scd4x"));
+        cs.onDataSent(onSent);
+        scd.attach(&cs);
+        CHECK(scd.begin());
+        hostAdvance(CS_SCD4X_PERIODIC_INTERVAL);
+        CHECK(scd.update());
+        CHECK_TEXT(lastLine, "812,25.0,50.0,7");
+    }
+
+    {
+        // Loop blocked for 12 s: the measurement in between is lost
+        ChronoSenseSCD4xSimulator sensor;
+        ChronoSenseSCD4x scd(&sensor);
+        CHECK(scd.begin());
+        hostAdvance(CS_SCD4X_PERIODIC_INTERVAL);
+        CHECK(scd.update());
+        hostAdvance(12000);
+        CHECK(scd.update());
+        CHECK(scd.getStats().missedCycles == 1);
+        CHECK(scd.getStats().readings + scd.getStats().missedCycles == sensor.getMeasurements());
+    }
+
+    printf("testSCD4x: pass\n");
+    return 0;
+}